@@ -1,8 +1,13 @@
 #include <atomic>
+#include <charconv>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory_resource>
+#include <optional>
 #include <queue>
-#include <thread>
+#include <sstream>
 
 #include "Include/Algorithms.hpp"
 #include "Include/Generator.hpp"
@@ -14,26 +19,6 @@
 namespace
 {
 
-/**
- * @brief Converts 1D index to 3D index.
- *
- * @param index The 1D index.
- * @param size The size of a matrix.
- * @return std::tuple<uint8_t, uint8_t, uint8_t>
- */
-std::tuple<uint8_t, uint8_t, uint8_t>
-index_to_coordinates(uint32_t index, uint8_t size)
-{
-  const uint16_t layer_size = size * size;
-  const uint16_t remainder  = index % layer_size;
-
-  const uint8_t  x          = remainder / size;
-  const uint8_t  y          = remainder % size;
-  const uint8_t  z          = index / layer_size;
-
-  return { x, y, z };
-}
-
 template <typename Tp>
 Tp
 get_config_number(const ini::Section& section, const std::string& key, Tp default_value, Tp min_value, Tp max_value, const std::string& error_message)
@@ -56,28 +41,864 @@ get_config_number(const ini::Section& section, const std::string& key, Tp defaul
   return value;
 }
 
+/**
+ * @brief Gets the routing directions of layers, one letter per layer: H - horizontal,
+ * V - vertical, A - any. The profile repeats over the depth.
+ *
+ * @param section The config section.
+ * @param key The key of the profile.
+ * @return std::vector<uint8_t> The directions of layers, empty if all of them are routed in any direction.
+ */
+std::vector<uint8_t>
+get_layer_directions(const ini::Section& section, const std::string& key)
+{
+  if(!section.check_key(key))
+    {
+      return {};
+    }
+
+  std::vector<uint8_t> layer_directions;
+
+  for(const char letter : section.get_as<std::string>(key))
+    {
+      switch(letter)
+        {
+        case 'H': layer_directions.push_back(types::HORIZONTAL_LAYER); break;
+        case 'V': layer_directions.push_back(types::VERTICAL_LAYER); break;
+        case 'A': layer_directions.push_back(types::ANY_DIRECTION_LAYER); break;
+        default:
+          std::cerr << key << " must consist of H, V and A letters." << std::endl;
+          std::cout << "Using default value instead, which is A." << std::endl;
+
+          return {};
+        }
+    }
+
+  return layer_directions;
+}
+
+/**
+ * @brief Output directories of the generated samples.
+ *
+ */
+struct Directories
+{
+  std::filesystem::path m_root;     ///< Output of the run, holds its manifest.
+  std::filesystem::path m_source;   ///< Source matrices.
+  std::filesystem::path m_target;   ///< Target matrices, or sparse trees if the sparse targets are on.
+  std::filesystem::path m_nodes;    ///< Terminals coordinates.
+  std::filesystem::path m_graph;    ///< Graph arrays, used only if the graph export is on.
+  std::filesystem::path m_features; ///< Extra input channels, used only if the features are on.
+  std::filesystem::path m_journal;  ///< Journals of the workers.
+};
+
+/**
+ * @brief Generation settings read from the config.
+ *
+ */
+struct Settings
+{
+  uint16_t             m_size                 = 32;
+  uint16_t             m_depth                = 1;
+  uint8_t              m_min_number_of_points = 2;
+  uint8_t              m_max_number_of_points = 4;
+  uint32_t             m_desired_combinations = 100;
+  uint16_t             m_tile_size            = 0;
+  uint16_t             m_tile_overlap         = 4;
+  std::vector<uint8_t> m_layer_directions;
+  bool                 m_export_graph         = false;
+  bool                 m_sparse_target        = false;
+  bool                 m_export_features      = false;
+  bool                 m_random_sampling      = false;
+  uint64_t             m_seed                 = 0;
+  uint32_t             m_threads              = 0; ///< Number of workers, 0 to use all available CPUs.
+  uint32_t             m_shard                = 0; ///< Part of the samples generated by this run.
+  uint32_t             m_shards               = 1; ///< Number of parts the samples are split into.
+};
+
+/**
+ * @brief Returns the routing directions of layers as letters, see get_layer_directions.
+ *
+ * @param layer_directions The directions of layers, empty if all of them are routed in any direction.
+ * @return std::string
+ */
+std::string
+layer_directions_name(const std::vector<uint8_t>& layer_directions)
+{
+  std::string name;
+
+  for(const uint8_t directions : layer_directions.empty() ? std::vector<uint8_t>{ types::ANY_DIRECTION_LAYER } : layer_directions)
+    {
+      name += directions == types::HORIZONTAL_LAYER ? 'H' : (directions == types::VERTICAL_LAYER ? 'V' : 'A');
+    }
+
+  return name;
+}
+
+/**
+ * @brief Returns the name of a sample. It depends only on the position of the sample in
+ * its sequence, so runs split in any way name a sample alike.
+ *
+ * @param settings The generation settings.
+ * @param number_of_points The number of terminals.
+ * @param sample The 0-based position of the sample.
+ * @return std::string
+ */
+std::string
+sample_name(const Settings& settings, const uint8_t number_of_points, const uint64_t sample)
+{
+  std::string name;
+
+  /** Appended onto a reserved string, "s" + std::to_string(...) trips a false -Wrestrict of GCC 12 */
+  name.reserve(32);
+  name.append("s").append(std::to_string(settings.m_size)).append("_d").append(std::to_string(settings.m_depth)).append("_p").append(std::to_string(number_of_points)).append("_n").append(std::to_string(sample + 1));
+
+  return name;
+}
+
+/**
+ * @brief Sample written by a run.
+ *
+ */
+struct ManifestEntry
+{
+  uint8_t  m_number_of_points; ///< Number of terminals.
+  uint64_t m_sample;           ///< 0-based position of the sample in its sequence.
+
+  auto
+  operator<=>(const ManifestEntry&) const = default;
+};
+
+/** Longest time a worker goes without flushing its journal */
+constexpr std::chrono::seconds CHECKPOINT_INTERVAL(10);
+
+/**
+ * @brief Returns the settings a dataset depends on, as they appear in its manifest. Shards
+ * of a dataset and resumed runs must agree on all of them.
+ *
+ * @param settings The generation settings.
+ * @return std::vector<std::pair<std::string, std::string>> Keys and values.
+ */
+std::vector<std::pair<std::string, std::string>>
+manifest_settings(const Settings& settings)
+{
+  return {
+    { "Shard", std::to_string(settings.m_shard) },
+    { "Shards", std::to_string(settings.m_shards) },
+    { "Size", std::to_string(settings.m_size) },
+    { "Depth", std::to_string(settings.m_depth) },
+    { "MinNumberOfPoints", std::to_string(settings.m_min_number_of_points) },
+    { "MaxNumberOfPoints", std::to_string(settings.m_max_number_of_points) },
+    { "DesiredCombinations", std::to_string(settings.m_desired_combinations) },
+    { "Sampling", settings.m_random_sampling ? "Random" : "Stride" },
+    { "Seed", std::to_string(settings.m_seed) },
+    { "LayerDirections", layer_directions_name(settings.m_layer_directions) },
+    { "Target", settings.m_sparse_target ? "Sparse" : "Dense" },
+    { "Graph", settings.m_export_graph ? "true" : "false" },
+    { "Features", settings.m_export_features ? "true" : "false" },
+  };
+}
+
+/**
+ * @brief Writes the settings of a run to Manifest.ini.
+ *
+ * @param settings The generation settings.
+ * @param directories The output directories.
+ * @param samples The number of samples, known once the run is done.
+ */
+void
+write_settings(const Settings& settings, const Directories& directories, const std::optional<std::size_t> samples = std::nullopt)
+{
+  std::ofstream settings_file(directories.m_root / "Manifest.ini");
+
+  settings_file << "[Manifest]\n\n";
+
+  for(const auto& [key, value] : manifest_settings(settings))
+    {
+      settings_file << key << " = " << value << "\n";
+    }
+
+  if(samples)
+    {
+      settings_file << "Samples = " << *samples << "\n";
+    }
+
+  if(!settings_file)
+    {
+      throw std::runtime_error("Manifest Error: Failed to write the manifest to \"" + directories.m_root.string() + "\".");
+    }
+}
+
+/**
+ * @brief Writes the manifest of a run: its samples, sorted, to Manifest.csv and then its
+ * settings to Manifest.ini. The Samples key of Manifest.ini marks the run as done.
+ *
+ * @param settings The generation settings.
+ * @param directories The output directories.
+ * @param entries The samples written by the run, sorted.
+ */
+void
+write_manifest(const Settings& settings, const Directories& directories, const std::vector<ManifestEntry>& entries)
+{
+  std::ofstream samples_file(directories.m_root / "Manifest.csv");
+
+  samples_file << "name,points,sample\n";
+
+  for(const auto& entry : entries)
+    {
+      samples_file << sample_name(settings, entry.m_number_of_points, entry.m_sample) << "," << uint32_t(entry.m_number_of_points) << "," << entry.m_sample + 1 << "\n";
+    }
+
+  samples_file.close();
+
+  if(!samples_file)
+    {
+      throw std::runtime_error("Manifest Error: Failed to write the manifest to \"" + directories.m_root.string() + "\".");
+    }
+
+  /** Written last, so a shard stopped before this point has no sample count */
+  write_settings(settings, directories, entries.size());
+}
+
+/**
+ * @brief Progress of a run read back from the journals of its workers.
+ *
+ */
+struct Journal
+{
+  std::vector<ManifestEntry>                                    m_entries; ///< Samples of the done ranges, sorted.
+  std::map<uint8_t, std::vector<std::pair<uint64_t, uint64_t>>> m_ranges;  ///< Done ranges of every number of points, sorted and disjoint.
+};
+
+/**
+ * @brief Reads the journals of the workers. A worker appends "sample,<points>,<position>"
+ * for every sample it writes and "range,<points>,<first>,<last>" once all samples of the
+ * range are written, positions are 0-based. Samples out of done ranges and lines cut short
+ * are left out.
+ *
+ * @param journal_directory The directory of the journals.
+ * @return Journal
+ */
+Journal
+read_journal(const std::filesystem::path& journal_directory)
+{
+  Journal journal;
+
+  if(!std::filesystem::is_directory(journal_directory))
+    {
+      return journal;
+    }
+
+  for(const auto& file_entry : std::filesystem::directory_iterator(journal_directory))
+    {
+      std::ifstream file(file_entry.path());
+      std::string   line;
+
+      while(std::getline(file, line))
+        {
+          std::array<uint64_t, 3> values;
+          const std::size_t       comma = line.find(',');
+          const std::string_view  kind  = std::string_view(line).substr(0, comma);
+          const char*             begin = line.data() + std::min(comma + 1, line.size());
+          const char*             end   = line.data() + line.size();
+          bool                    valid = comma != std::string::npos && (kind == "sample" || kind == "range");
+
+          const std::size_t       count = kind == "sample" ? 2 : 3;
+
+          for(std::size_t k = 0; k < count && valid; ++k)
+            {
+              const auto [next, error] = std::from_chars(begin, end, values[k]);
+
+              valid                    = error == std::errc() && (k + 1 == count ? next == end : next != end && *next == ',');
+              begin                    = next + 1;
+            }
+
+          if(!valid || values[0] > UINT8_MAX)
+            {
+              continue;
+            }
+
+          if(kind == "sample")
+            {
+              journal.m_entries.push_back({ uint8_t(values[0]), values[1] });
+            }
+          else
+            {
+              journal.m_ranges[uint8_t(values[0])].emplace_back(values[1], values[2]);
+            }
+        }
+    }
+
+  for(auto& [number_of_points, ranges] : journal.m_ranges)
+    {
+      std::sort(ranges.begin(), ranges.end());
+
+      std::vector<std::pair<uint64_t, uint64_t>> merged;
+
+      for(const auto& range : ranges)
+        {
+          if(!merged.empty() && range.first <= merged.back().second)
+            {
+              merged.back().second = std::max(merged.back().second, range.second);
+            }
+          else
+            {
+              merged.push_back(range);
+            }
+        }
+
+      ranges = std::move(merged);
+    }
+
+  /** Samples are journaled again when a range is redone */
+  std::sort(journal.m_entries.begin(), journal.m_entries.end());
+  journal.m_entries.erase(std::unique(journal.m_entries.begin(), journal.m_entries.end()), journal.m_entries.end());
+
+  std::erase_if(journal.m_entries, [&journal](const ManifestEntry& entry) {
+    const auto it = journal.m_ranges.find(entry.m_number_of_points);
+
+    if(it == journal.m_ranges.end())
+      {
+        return true;
+      }
+
+    const auto range = std::upper_bound(it->second.begin(), it->second.end(), std::pair<uint64_t, uint64_t>(entry.m_sample, UINT64_MAX));
+
+    return range == it->second.begin() || std::prev(range)->second <= entry.m_sample;
+  });
+
+  return journal;
+}
+
+/**
+ * @brief Returns the parts of a range of samples not covered by the done ranges.
+ *
+ * @param first The first sample.
+ * @param last Past the last sample.
+ * @param done Sorted disjoint done ranges.
+ * @return std::vector<std::pair<uint64_t, uint64_t>>
+ */
+std::vector<std::pair<uint64_t, uint64_t>>
+remaining_ranges(const uint64_t first, const uint64_t last, const std::vector<std::pair<uint64_t, uint64_t>>& done)
+{
+  std::vector<std::pair<uint64_t, uint64_t>> remaining;
+  uint64_t                                   position = first;
+
+  for(const auto& [done_first, done_last] : done)
+    {
+      if(done_first > position)
+        {
+          remaining.emplace_back(position, std::min(done_first, last));
+        }
+
+      position = std::max(position, done_last);
+
+      if(position >= last)
+        {
+          break;
+        }
+    }
+
+  if(position < last)
+    {
+      remaining.emplace_back(position, last);
+    }
+
+  std::erase_if(remaining, [](const auto& range) { return range.first >= range.second; });
+
+  return remaining;
+}
+
+/**
+ * @brief Merges the manifests of the shards in the output directory into Index.csv, the
+ * samples of all shards in order along with the shard that holds each of them.
+ *
+ * @param output_directory The output directory with a Shard_<i>_of_<N> directory per shard.
+ * @return int Exit code, non-zero if the shards are missing, unfinished, overlap or disagree.
+ */
+int
+merge(const std::filesystem::path& output_directory)
+{
+  std::vector<std::filesystem::path> shard_directories;
+
+  if(std::filesystem::is_directory(output_directory))
+    {
+      for(const auto& entry : std::filesystem::directory_iterator(output_directory))
+        {
+          if(entry.is_directory() && entry.path().filename().string().starts_with("Shard_") && std::filesystem::exists(entry.path() / "Manifest.ini"))
+            {
+              shard_directories.push_back(entry.path());
+            }
+        }
+    }
+
+  if(shard_directories.empty())
+    {
+      std::cerr << "No shard manifests found in " << output_directory << "." << std::endl;
+      return 1;
+    }
+
+  std::sort(shard_directories.begin(), shard_directories.end());
+
+  const ini::Config reference = ini::parse(shard_directories.front() / "Manifest.ini");
+  const uint32_t    shards    = reference.at("Manifest").get_as<uint32_t>("Shards");
+
+  std::vector<bool> found(shards, false);
+
+  /** Sample, then shard directory and sample name */
+  std::vector<std::pair<ManifestEntry, std::pair<std::string, std::string>>> index;
+
+  for(const auto& shard_directory : shard_directories)
+    {
+      const ini::Config   config   = ini::parse(shard_directory / "Manifest.ini");
+      const ini::Section& manifest = config.at("Manifest");
+      const uint32_t      shard    = manifest.get_as<uint32_t>("Shard");
+
+      for(const auto& [key, value] : manifest_settings(Settings{}))
+        {
+          if(key == "Shard")
+            {
+              continue;
+            }
+
+          if(manifest.get_as<std::string>(key) != reference.at("Manifest").get_as<std::string>(key))
+            {
+              std::cerr << key << " of " << shard_directory << " differs from the other shards." << std::endl;
+              return 1;
+            }
+        }
+
+      if(shard >= shards || found[shard])
+        {
+          std::cerr << "Shard " << shard << " of " << shard_directory << " is out of range or found twice." << std::endl;
+          return 1;
+        }
+
+      found[shard] = true;
+
+      /** The sample count is only written once the shard is done */
+      if(!manifest.check_key("Samples") || !std::filesystem::exists(shard_directory / "Manifest.csv"))
+        {
+          std::cerr << "Shard " << shard << " of " << shard_directory << " is not finished." << std::endl;
+          return 1;
+        }
+
+      const std::size_t samples = manifest.get_as<std::size_t>("Samples");
+      const std::size_t first   = index.size();
+
+      std::ifstream     samples_file(shard_directory / "Manifest.csv");
+      std::string       line;
+
+      /** Skip the header */
+      if(!std::getline(samples_file, line))
+        {
+          std::cerr << "Failed to read the manifest of " << shard_directory << "." << std::endl;
+          return 1;
+        }
+
+      while(std::getline(samples_file, line))
+        {
+          std::istringstream stream(line);
+          std::string        name;
+          std::string        points;
+          std::string        sample;
+
+          std::getline(stream, name, ',');
+          std::getline(stream, points, ',');
+          std::getline(stream, sample, ',');
+
+          const ManifestEntry entry{ uint8_t(std::stoul(points)), std::stoull(sample) - 1 };
+
+          index.push_back({ entry, { shard_directory.filename().string(), name } });
+        }
+
+      if(index.size() - first != samples)
+        {
+          std::cerr << "Shard " << shard << " of " << shard_directory << " lists " << index.size() - first << " of its " << samples << " samples." << std::endl;
+          return 1;
+        }
+    }
+
+  if(std::find(found.begin(), found.end(), false) != found.end())
+    {
+      std::cerr << "Only " << std::count(found.begin(), found.end(), true) << " of " << shards << " shards were found." << std::endl;
+      return 1;
+    }
+
+  std::sort(index.begin(), index.end());
+
+  for(std::size_t i = 1; i < index.size(); ++i)
+    {
+      if(index[i - 1].first == index[i].first)
+        {
+          std::cerr << "Sample " << index[i].second.second << " is held by both " << index[i - 1].second.first << " and " << index[i].second.first << "." << std::endl;
+          return 1;
+        }
+    }
+
+  std::ofstream index_file(output_directory / "Index.csv");
+
+  index_file << "shard,name,points,sample\n";
+
+  for(const auto& [entry, location] : index)
+    {
+      index_file << location.first << "," << location.second << "," << uint32_t(entry.m_number_of_points) << "," << entry.m_sample + 1 << "\n";
+    }
+
+  std::cout << "  - Shards : " << shards << std::endl;
+  std::cout << "  - Samples: " << index.size() << std::endl;
+  std::cout << "  - Index  : " << (output_directory / "Index.csv") << std::endl;
+
+  return 0;
+}
+
+/**
+ * @brief Buffers of a worker that are cleared and reused for every sample.
+ *
+ * @tparam Extent The type of a coordinate.
+ */
+template <typename Extent>
+struct SampleWorkspace
+{
+  std::vector<matrix::Coordinates<Extent>>   m_terminals;          ///< Terminals of the sample.
+  std::vector<Extent>                        m_nodes_coordinates;  ///< Terminals coordinates padded to the max number of points.
+  std::vector<uint16_t>                      m_features;           ///< Extra input channels.
+  matrix::BasicMatrix<Extent>                m_source;             ///< Source matrix.
+  matrix::BasicMatrix<Extent>                m_target;             ///< Target matrix, empty if the sparse targets are on.
+  graph::Graph                               m_graph;              ///< Graph of the trace terrain.
+  std::vector<matrix::Coordinates<Extent>>   m_nodes;              ///< Coordinates of the graph nodes.
+  std::pmr::unsynchronized_pool_resource     m_memory;             ///< Pool of the layout, masks and maps of the terrain tracer.
+  algorithms::Workspace                      m_solver;             ///< Buffers of the solver.
+  std::vector<std::pair<uint32_t, uint32_t>> m_tiled_mst;          ///< Solution of the tiled solver.
+  std::size_t                                m_worker = 0;         ///< Index of the worker owning the workspace.
+  std::ofstream                              m_journal;            ///< Journal of the samples written by the worker.
+  std::chrono::steady_clock::time_point      m_checkpoint;         ///< Last time the journal was flushed.
+};
+
+/**
+ * @brief Samples drawn for a number of points.
+ *
+ */
+struct Draw
+{
+  uint8_t                                    m_number_of_points;
+  std::shared_ptr<const gen::BinomialTable>  m_binomials;    ///< Shared by all draws, null for random samples.
+  gen::Rank                                  m_combinations; ///< Number of combinations, 0 for random samples.
+  gen::Rank                                  m_step;         ///< Distance between ranks of consecutive samples.
+  uint64_t                                   m_samples;      ///< Number of samples in the sequence.
+  std::vector<std::pair<uint64_t, uint64_t>> m_remaining; ///< Ranges of samples of the shard left to generate.
+};
+
+/**
+ * @brief Generates the samples for all numbers of points.
+ *
+ * @tparam Extent The type of a coordinate, wide enough for the size and the depth.
+ * @param settings The generation settings.
+ * @param directories The output directories.
+ * @return uint64_t The number of instances skipped since the trace terrain doesn't connect their terminals.
+ */
+template <typename Extent>
+uint64_t
+generate(const Settings& settings, const Directories& directories)
+{
+  const Extent         size                 = settings.m_size;
+  const Extent         depth                = settings.m_depth;
+  const uint8_t        min_number_of_points = settings.m_min_number_of_points;
+  const uint8_t        max_number_of_points = settings.m_max_number_of_points;
+  const uint32_t       desired_combinations = settings.m_desired_combinations;
+  const uint16_t       tile_size            = settings.m_tile_size;
+  const uint16_t       tile_overlap         = settings.m_tile_overlap;
+  const std::size_t    number_of_workers    = settings.m_threads;
+  const uint32_t       total_cells          = uint32_t(size) * size * depth;
+
+  /** Stride samples are evenly spaced ranks, a sample is named by its position so that any split among the workers names it alike */
+  std::vector<Draw>    draws;
+  uint64_t             total_samples        = 0;
+  Journal              journal              = read_journal(directories.m_journal);
+
+  /** The table of the most points holds the columns of every lower number, all draws share it */
+  const std::shared_ptr<const gen::BinomialTable> binomials = settings.m_random_sampling ? nullptr : std::make_shared<const gen::BinomialTable>(total_cells, max_number_of_points);
+
+  for(uint8_t i = min_number_of_points; i <= max_number_of_points; ++i)
+    {
+      Draw draw{ i, binomials, 0, 1, desired_combinations, {} };
+
+      if(!settings.m_random_sampling)
+        {
+          draw.m_combinations = draw.m_binomials->nCr(total_cells, i);
+          draw.m_step         = std::max<gen::Rank>(draw.m_combinations / desired_combinations, 1);
+          draw.m_samples      = uint64_t(draw.m_combinations / draw.m_step + (draw.m_combinations % draw.m_step != 0));
+        }
+
+      /** Shards take even consecutive parts of every sequence, ranges in the journal are already done */
+      const uint64_t first = uint64_t(gen::Rank(draw.m_samples) * settings.m_shard / settings.m_shards);
+      const uint64_t last  = uint64_t(gen::Rank(draw.m_samples) * (settings.m_shard + 1) / settings.m_shards);
+
+      draw.m_remaining     = remaining_ranges(first, last, journal.m_ranges[i]);
+
+      for(const auto& [range_first, range_last] : draw.m_remaining)
+        {
+          total_samples += range_last - range_first;
+        }
+
+      draws.push_back(std::move(draw));
+    }
+
+  const std::string progress_bar_message = "Combinations for " + (min_number_of_points == max_number_of_points ? std::to_string(min_number_of_points) : std::to_string(min_number_of_points) + "-" + std::to_string(max_number_of_points)) + " points";
+
+  utils::SyncProgressBar progress_bar(total_samples, progress_bar_message);
+
+  std::vector<SampleWorkspace<Extent>> workspaces(number_of_workers);
+
+  for(auto& workspace : workspaces)
+    {
+      /** Sparse targets are never rasterized */
+      workspace.m_source = matrix::BasicMatrix<Extent>({ size, size, depth });
+      workspace.m_target = matrix::BasicMatrix<Extent>(settings.m_sparse_target ? matrix::BasicShape<Extent>{} : matrix::BasicShape<Extent>{ size, size, depth });
+
+      workspace.m_terminals.reserve(max_number_of_points);
+    }
+
+  /** Workers of a resumed run append to the journals of the same index, a fresh line ends any line cut short */
+  for(std::size_t j = 0; j < number_of_workers; ++j)
+    {
+      workspaces[j].m_worker = j;
+      workspaces[j].m_journal.open(directories.m_journal / ("Worker_" + std::to_string(j) + ".csv"), std::ios::app);
+      workspaces[j].m_journal << "\n";
+      workspaces[j].m_checkpoint = std::chrono::steady_clock::now();
+    }
+
+  /**
+   * Every number of points is cut into a few chunks per worker and all of them are queued at
+   * once, the most points first since they take the longest. Idle workers steal the rest, and
+   * help with the tiles of a sample when tiled solving is on.
+   */
+  constexpr uint64_t                 chunks_per_worker = 8;
+
+  utils::TaskPool                    pool(number_of_workers);
+  std::vector<algorithms::Workspace> tile_workspaces(tile_size == 0 ? 0 : number_of_workers);
+
+  /** Writes a sample */
+  auto save = [&](SampleWorkspace<Extent>& workspace, const std::string& sample_name, const std::vector<matrix::Coordinates<Extent>>& sample_terminals, const std::vector<matrix::Coordinates<Extent>>& sample_nodes, const std::vector<std::pair<uint32_t, uint32_t>>& mst) {
+    const std::string matrix_name       = sample_name + ".npy";
+
+    auto&             nodes_coordinates = workspace.m_nodes_coordinates;
+    auto&             source_matrix     = workspace.m_source;
+    auto&             target_matrix     = workspace.m_target;
+
+    nodes_coordinates.assign(max_number_of_points * 3, 0);
+
+    for(std::size_t k = 0; k < sample_terminals.size(); ++k)
+      {
+        std::tie(nodes_coordinates[k * 3], nodes_coordinates[k * 3 + 1], nodes_coordinates[k * 3 + 2]) = sample_terminals[k];
+      }
+
+    transform::terminals_to_matrix(source_matrix, sample_terminals);
+
+    numpy::save_as<uint8_t>(directories.m_source / matrix_name, reinterpret_cast<const char*>(source_matrix.data()), { depth, size, size });
+
+    if(settings.m_export_features)
+      {
+        transform::terminals_to_features<Extent>(workspace.m_features, { size, size, depth }, sample_terminals);
+
+        numpy::save_as<uint16_t>(directories.m_features / matrix_name, reinterpret_cast<const char*>(workspace.m_features.data()), { 2, depth, size, size });
+      }
+
+    /** Sparse trees share the sample name and differ by suffix */
+    if(settings.m_sparse_target)
+      {
+        const transform::SparseTree<Extent> tree = transform::mst_to_sparse(mst, sample_nodes);
+
+        numpy::save_as<Extent>(directories.m_target / (sample_name + "_points.npy"), reinterpret_cast<const char*>(tree.m_points.data()), { tree.m_points.size() / 3, 3 });
+        numpy::save_as<uint32_t>(directories.m_target / (sample_name + "_segments.npy"), reinterpret_cast<const char*>(tree.m_segments.data()), { tree.m_segments.size() / 2, 2 });
+      }
+    else
+      {
+        transform::mst_to_matrix(target_matrix, mst, sample_nodes);
+
+        numpy::save_as<uint8_t>(directories.m_target / matrix_name, reinterpret_cast<const char*>(target_matrix.data()), { depth, size, size });
+      }
+
+    numpy::save_as<Extent>(directories.m_nodes / matrix_name, reinterpret_cast<const char*>(nodes_coordinates.data()), { max_number_of_points, 3 });
+
+    /** Graph arrays share the sample name and differ by suffix */
+    if(settings.m_export_graph)
+      {
+        const transform::CsrGraph<Extent> csr = transform::graph_to_csr(workspace.m_graph, sample_nodes, mst);
+
+        numpy::save_as<Extent>(directories.m_graph / (sample_name + "_features.npy"), reinterpret_cast<const char*>(csr.m_features.data()), { sample_nodes.size(), 4 });
+        numpy::save_as<uint32_t>(directories.m_graph / (sample_name + "_indptr.npy"), reinterpret_cast<const char*>(csr.m_indptr.data()), { csr.m_indptr.size() });
+        numpy::save_as<uint32_t>(directories.m_graph / (sample_name + "_indices.npy"), reinterpret_cast<const char*>(csr.m_indices.data()), { csr.m_indices.size() });
+        numpy::save_as<uint32_t>(directories.m_graph / (sample_name + "_weights.npy"), reinterpret_cast<const char*>(csr.m_weights.data()), { csr.m_weights.size() });
+        numpy::save_as<uint8_t>(directories.m_graph / (sample_name + "_labels.npy"), reinterpret_cast<const char*>(csr.m_labels.data()), { csr.m_labels.size() });
+      }
+  };
+
+  std::atomic<uint64_t> unconnected_samples = 0;
+
+  /** Solves and writes a sample */
+  auto solve = [&](SampleWorkspace<Extent>& workspace, const uint8_t i, const std::span<const uint32_t> combination, const uint64_t sample) {
+    auto& terminals    = workspace.m_terminals;
+    auto& source_graph = workspace.m_graph;
+    auto& nodes        = workspace.m_nodes;
+
+    terminals.clear();
+
+    for(const auto index : combination)
+      {
+        terminals.push_back(transform::index_to_coordinates<Extent>(index, size));
+      }
+
+    /** Solve on the graph built straight from the terminals, the matrix is only needed for the output */
+    transform::terminals_to_graph<Extent>(source_graph, nodes, { size, size, depth }, terminals, settings.m_layer_directions, &workspace.m_memory);
+
+    if(tile_size != 0)
+      {
+        workspace.m_tiled_mst = algorithms::tiled_dijkstra_kruskal_greedy(source_graph, nodes, tile_size, tile_overlap, pool, workspace.m_worker, tile_workspaces);
+      }
+
+    const std::vector<std::pair<uint32_t, uint32_t>>& mst = tile_size == 0 ? algorithms::dijkstra_kruskal_greedy(source_graph, workspace.m_solver) : workspace.m_tiled_mst;
+
+    /** The trace terrain doesn't always join the terminals of different layers, such an instance has no sample */
+    if(!algorithms::spans_terminals(source_graph, mst, terminals.size()))
+      {
+        ++unconnected_samples;
+        return;
+      }
+
+    save(workspace, sample_name(settings, i, sample), terminals, nodes, mst);
+    workspace.m_journal << "sample," << uint32_t(i) << "," << sample << "\n";
+  };
+
+  /** Marks a range as done, its samples are already in the journal */
+  auto checkpoint = [&](SampleWorkspace<Extent>& workspace, const uint8_t i, const uint64_t first, const uint64_t last) {
+    workspace.m_journal << "range," << uint32_t(i) << "," << first << "," << last << "\n" << std::flush;
+    workspace.m_checkpoint = std::chrono::steady_clock::now();
+
+    if(!workspace.m_journal)
+      {
+        throw std::runtime_error("Journal Error: Failed to write the journal of a worker.");
+      }
+  };
+
+  /** Solves and writes the samples of a range, the first one at the given position */
+  auto run = [&](SampleWorkspace<Extent>& workspace, const uint8_t i, auto itr, const auto& itr_end, uint64_t sample) {
+    uint64_t journaled = sample;
+
+    for(; itr < itr_end; ++itr, ++sample)
+      {
+        solve(workspace, i, *itr, sample);
+
+        progress_bar.step();
+
+        if(std::chrono::steady_clock::now() - workspace.m_checkpoint >= CHECKPOINT_INTERVAL)
+          {
+            checkpoint(workspace, i, journaled, sample + 1);
+            journaled = sample + 1;
+          }
+      }
+
+    if(journaled < sample)
+      {
+        checkpoint(workspace, i, journaled, sample);
+      }
+  };
+
+  for(auto draw = draws.rbegin(); draw != draws.rend(); ++draw)
+    {
+      uint64_t remaining = 0;
+
+      for(const auto& [range_first, range_last] : draw->m_remaining)
+        {
+          remaining += range_last - range_first;
+        }
+
+      const uint64_t chunk_size = std::max<uint64_t>((remaining + number_of_workers * chunks_per_worker - 1) / (number_of_workers * chunks_per_worker), 1);
+
+      for(const auto& [range_first, range_last] : draw->m_remaining)
+        {
+          for(uint64_t first = range_first; first < range_last; first += chunk_size)
+            {
+              const uint64_t last = std::min(first + chunk_size, range_last);
+
+              pool.submit([&, draw = &*draw, first, last](const std::size_t worker) {
+                const uint8_t i = draw->m_number_of_points;
+
+                if(settings.m_random_sampling)
+                  {
+                    run(workspaces[worker], i, gen::RandomItr(total_cells, i, settings.m_seed, first, last), gen::RandomItr(total_cells, i, settings.m_seed, last, last), first);
+                  }
+                else
+                  {
+                    /** Past the last sample the range ends at the number of combinations, below it the rank can't overflow */
+                    const gen::Rank start_idx = first * draw->m_step;
+                    const gen::Rank end_idx   = last == draw->m_samples ? draw->m_combinations : last * draw->m_step;
+
+                    run(workspaces[worker], i, gen::GeneratorItr(draw->m_binomials, draw->m_number_of_points, draw->m_step, start_idx, end_idx), gen::GeneratorItr(draw->m_binomials, draw->m_number_of_points, draw->m_step, end_idx, end_idx), first);
+                  }
+              });
+            }
+        }
+    }
+
+  pool.wait();
+
+  for(auto& workspace : workspaces)
+    {
+      workspace.m_journal.close();
+    }
+
+  /** The journals of all attempts make up the manifest */
+  write_manifest(settings, directories, read_journal(directories.m_journal).m_entries);
+
+  return unconnected_samples;
+}
+
 } // namespace
 
 int
 main(int argc, char* argv[])
 {
   std::filesystem::path config_path = "./config.ini";
+  Settings              settings;
+  bool                  merge_shards = false;
+  bool                  resume       = false;
 
   /** Simple arg-parser */
-  if(argc > 1)
+  for(int i = 1; i < argc; ++i)
     {
-      if(std::strcmp(argv[1], "--config") == 0 && argc > 2)
+      if(std::strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+        {
+          config_path = argv[++i];
+        }
+      else if(std::strcmp(argv[i], "--shard") == 0 && i + 1 < argc)
+        {
+          /** i/N, shards are counted from 0 */
+          uint32_t shard  = 0;
+          uint32_t shards = 0;
+          char     rest   = 0;
+
+          if(std::sscanf(argv[++i], "%u/%u%c", &shard, &shards, &rest) != 2 || shards == 0 || shard >= shards)
+            {
+              std::cerr << "Shard must be i/N with 0 <= i < N." << std::endl;
+              return 1;
+            }
+
+          settings.m_shard  = shard;
+          settings.m_shards = shards;
+        }
+      else if(std::strcmp(argv[i], "--merge") == 0)
+        {
+          merge_shards = true;
+        }
+      else if(std::strcmp(argv[i], "--resume") == 0)
         {
-          config_path = argv[2];
+          resume = true;
         }
     }
 
   ini::Config config = ini::parse(config_path);
 
-  /** Setup output directory and its subdirectories */
-  std::cout << "\n";
-  std::cout << "============= Setting up output directories =============" << std::endl;
-
   std::filesystem::path output_directory = std::filesystem::current_path() / "GeneratedData";
 
   if(auto it = config.find("Path"); it != config.end())
@@ -87,279 +908,242 @@ main(int argc, char* argv[])
       output_directory       = ps.get_as<std::string>("Output");
     }
 
+  if(merge_shards)
+    {
+      std::cout << "\n";
+      std::cout << "================= Merging shard manifests ================" << std::endl;
+
+      return merge(output_directory);
+    }
+
+  /** Setup output directory and its subdirectories */
+  std::cout << "\n";
+  std::cout << "============= Setting up output directories =============" << std::endl;
+
+  /** A shard owns only its own directory, so that shards may share the output directory */
+  if(settings.m_shards > 1)
+    {
+      output_directory /= "Shard_" + std::to_string(settings.m_shard) + "_of_" + std::to_string(settings.m_shards);
+    }
+
   if(!std::filesystem::exists(output_directory))
     {
       std::filesystem::create_directories(output_directory);
     }
 
-  const std::filesystem::path source_dir = output_directory / "Source";
-  const std::filesystem::path target_dir = output_directory / "Target";
-  const std::filesystem::path nodes_dir  = output_directory / "Nodes";
+  Directories directories;
+
+  directories.m_root     = output_directory;
 
-  for(const auto& dir : { source_dir, target_dir, nodes_dir })
+  directories.m_source   = output_directory / "Source";
+  directories.m_target   = output_directory / "Target";
+  directories.m_nodes    = output_directory / "Nodes";
+  directories.m_graph    = output_directory / "Graph";
+  directories.m_features = output_directory / "Features";
+  directories.m_journal  = output_directory / "Journal";
+
+  if(auto it = config.find("Output"); it != config.end())
     {
-      if(std::filesystem::exists(dir))
+      const ini::Section& os = it->second;
+
+      if(os.check_key("Graph"))
         {
-          std::filesystem::remove_all(dir);
+          settings.m_export_graph = os.get_as<bool>("Graph");
+        }
+
+      if(os.check_key("Features"))
+        {
+          settings.m_export_features = os.get_as<bool>("Features");
         }
 
-      std::filesystem::create_directory(dir);
+      if(os.check_key("Target"))
+        {
+          const std::string target = os.get_as<std::string>("Target");
+
+          if(target == "Sparse" || target == "Dense")
+            {
+              settings.m_sparse_target = target == "Sparse";
+            }
+          else
+            {
+              std::cerr << "Target must be Dense or Sparse." << std::endl;
+              std::cout << "Using default value instead, which is Dense." << std::endl;
+            }
+        }
     }
 
-  std::cout << "  - Source directory: " << source_dir << std::endl;
-  std::cout << "  - Target directory: " << target_dir << std::endl;
-  std::cout << "  - Nodes  directory: " << target_dir << std::endl;
+  std::cout << "  - Source directory: " << directories.m_source << std::endl;
+  std::cout << "  - Target directory: " << directories.m_target << (settings.m_sparse_target ? " (sparse)" : "") << std::endl;
+  std::cout << "  - Nodes  directory: " << directories.m_target << std::endl;
+  std::cout << "  - Graph  directory: " << (settings.m_export_graph ? directories.m_graph.string() : std::string("off")) << std::endl;
+  std::cout << "  - Features directory: " << (settings.m_export_features ? directories.m_features.string() : std::string("off")) << std::endl;
   std::cout << "\n";
 
   /** Setup up generation settings */
   std::cout << "=================== Generating samples ===================" << std::endl;
 
-  uint8_t  size                 = 32;
-  uint8_t  depth                = 1;
-  uint8_t  min_number_of_points = 2;
-  uint8_t  max_number_of_points = 4;
-  uint32_t desired_combinations = 100;
-
   if(auto it = config.find("Generation"); it != config.end())
     {
-      const ini::Section& gs = it->second;
-
-      size                   = get_config_number<uint8_t>(gs, "Size", size, 1, UINT8_MAX, "Size must be between 1 and 255.");
-      depth                  = get_config_number<uint8_t>(gs, "Depth", depth, 1, UINT8_MAX, "Depth must be between 1 and 255.");
-      min_number_of_points   = get_config_number<uint8_t>(gs, "MinNumberOfPoints", min_number_of_points, 1, UINT8_MAX, "MinNumberOfPoints must be between 1 and 255.");
-      max_number_of_points   = get_config_number<uint8_t>(gs, "MaxNumberOfPoints", max_number_of_points, 1, UINT8_MAX, "MaxNumberOfPoints must be between 1 and 255.");
-      desired_combinations   = get_config_number<uint32_t>(gs, "DesiredCombinations", desired_combinations, 1, UINT32_MAX, "DesiredCombinations must be between 1 and 4294967295.");
+      const ini::Section& gs          = it->second;
+
+      settings.m_size                 = get_config_number<uint16_t>(gs, "Size", settings.m_size, 1, UINT16_MAX, "Size must be between 1 and 65535.");
+      settings.m_depth                = get_config_number<uint16_t>(gs, "Depth", settings.m_depth, 1, UINT16_MAX, "Depth must be between 1 and 65535.");
+      settings.m_min_number_of_points = get_config_number<uint8_t>(gs, "MinNumberOfPoints", settings.m_min_number_of_points, 1, UINT8_MAX, "MinNumberOfPoints must be between 1 and 255.");
+      settings.m_max_number_of_points = get_config_number<uint8_t>(gs, "MaxNumberOfPoints", settings.m_max_number_of_points, 1, UINT8_MAX, "MaxNumberOfPoints must be between 1 and 255.");
+      settings.m_desired_combinations = get_config_number<uint32_t>(gs, "DesiredCombinations", settings.m_desired_combinations, 1, UINT32_MAX, "DesiredCombinations must be between 1 and 4294967295.");
+      settings.m_tile_size            = get_config_number<uint16_t>(gs, "TileSize", settings.m_tile_size, 0, UINT16_MAX, "TileSize must be between 0 and 65535.");
+      settings.m_tile_overlap         = get_config_number<uint16_t>(gs, "TileOverlap", settings.m_tile_overlap, 0, UINT16_MAX, "TileOverlap must be between 0 and 65535.");
+      settings.m_layer_directions     = get_layer_directions(gs, "LayerDirections");
+      settings.m_threads              = get_config_number<uint32_t>(gs, "Threads", settings.m_threads, 0, 4096, "Threads must be between 0 and 4096.");
+      settings.m_seed                 = get_config_number<uint64_t>(gs, "Seed", settings.m_seed, 0, UINT64_MAX, "Seed must be between 0 and 18446744073709551615.");
+
+      if(gs.check_key("Sampling"))
+        {
+          const std::string sampling = gs.get_as<std::string>("Sampling");
+
+          if(sampling == "Random" || sampling == "Stride")
+            {
+              settings.m_random_sampling = sampling == "Random";
+            }
+          else
+            {
+              std::cerr << "Sampling must be Stride or Random." << std::endl;
+              std::cout << "Using default value instead, which is Stride." << std::endl;
+            }
+        }
     }
 
-  std::cout << "  - Size                : " << uint32_t(size) << std::endl;
-  std::cout << "  - Depth               : " << uint32_t(depth) << std::endl;
-  std::cout << "  - Min number of points: " << uint32_t(min_number_of_points) << std::endl;
-  std::cout << "  - Max number of points: " << uint32_t(max_number_of_points) << std::endl;
-  std::cout << "  - Desired combinations: " << desired_combinations << std::endl;
-  std::cout << "\n";
-
-/** Generate source matrices */
-
-/** Go trough all number of points */
+  /** Workers default to the available CPUs, debug builds run one */
+  if(settings.m_threads == 0)
+    {
 #ifdef DLRS_DEBUG
-  const std::size_t number_of_threads = 1;
+      settings.m_threads = 1;
 #else
-  const std::size_t number_of_threads = std::thread::hardware_concurrency() / 2;
+      settings.m_threads = utils::available_cpus();
 #endif
-  const uint32_t total_cells = size * size * depth;
+    }
 
-  for(uint8_t i = min_number_of_points; i <= max_number_of_points; ++i)
+  /** Cells are enumerated by 32-bit indices */
+  if(uint64_t(settings.m_size) * settings.m_size * settings.m_depth > UINT32_MAX)
     {
-      const uint64_t           possible_combinations           = gen::nCr(total_cells, i);
-      const uint64_t           combinations_per_thread         = possible_combinations / number_of_threads;
-      const uint64_t           desired_combinations_per_thread = desired_combinations / number_of_threads;
-
-      const std::string        progress_bar_message            = "Combinations for " + std::to_string(i) + " points";
+      std::cerr << "Size * Size * Depth must not exceed 4294967295." << std::endl;
+      std::cout << "Using default values instead, which are " << std::to_string(Settings{}.m_size) << " and " << std::to_string(Settings{}.m_depth) << "." << std::endl;
 
-      utils::SyncProgressBar   progress_bar(desired_combinations, progress_bar_message);
-
-      std::vector<std::thread> threads(number_of_threads);
-      std::atomic<int64_t>     counter(0);
-
-      for(std::size_t j = 0; j < number_of_threads; ++j)
-        {
-          auto worker = [&, j]() {
-            const uint64_t    start_idx = j * combinations_per_thread;
-            const uint64_t    end_idx   = (j == number_of_threads - 1) ? possible_combinations : start_idx + combinations_per_thread;
-            const uint64_t    step      = (end_idx - start_idx) / desired_combinations_per_thread;
+      settings.m_size  = Settings{}.m_size;
+      settings.m_depth = Settings{}.m_depth;
+    }
 
-            gen::GeneratorItr itr(total_cells, i, step, start_idx, end_idx);
-            gen::GeneratorItr itr_end(total_cells, i, step, end_idx, end_idx);
+  /** The profile repeats over the depth, and vias join the layers, so some layer within the depth must route each direction */
+  uint8_t routed_directions = settings.m_layer_directions.empty() ? types::ANY_DIRECTION_LAYER : 0;
 
-            for(; itr < itr_end; ++itr)
-              {
-                const std::vector<uint32_t> indices = *itr;
+  for(std::size_t z = 0, end = std::min<std::size_t>(settings.m_depth, settings.m_layer_directions.size()); z < end; ++z)
+    {
+      routed_directions |= settings.m_layer_directions[z];
+    }
 
-                /** Go trough possible combinations */
-                matrix::Matrix              source_matrix({ size, size, depth });
-                std::vector<uint8_t>        nodes_coordinates(max_number_of_points * 3, 0);
+  if(routed_directions != types::ANY_DIRECTION_LAYER)
+    {
+      std::cerr << "LayerDirections must route both directions within the first " << settings.m_depth << " layers." << std::endl;
+      std::cout << "Using default value instead, which is A." << std::endl;
 
-                std::size_t                 index_counter = 0;
+      settings.m_layer_directions.clear();
+    }
 
-                std::size_t                 x_collisions  = 0;
-                std::size_t                 y_collisions  = 0;
+  /** Ranks are 128-bit, the binomial table holds nCr up to r = min(points, cells / 2). Random samples have no ranks */
+  const uint32_t total_cells = uint32_t(settings.m_size) * settings.m_size * settings.m_depth;
+
+  auto           fits        = [total_cells](const uint8_t number_of_points) {
+    try
+      {
+        gen::nCr(total_cells, std::min<uint32_t>(number_of_points, total_cells / 2));
+        return true;
+      }
+    catch(const std::overflow_error&)
+      {
+        return false;
+      }
+  };
+
+  if(!settings.m_random_sampling && !fits(settings.m_max_number_of_points))
+    {
+      uint8_t number_of_points = settings.m_max_number_of_points;
 
-                /** Fill the matrix */
-                for(const auto index : indices)
-                  {
-                    const auto [c_x, c_y, c_z] = index_to_coordinates(index, size);
-
-                    source_matrix.set_at(types::TERMINAL_CELL, c_x, c_y, c_z);
-
-                    nodes_coordinates[index_counter * 3]     = c_x;
-                    nodes_coordinates[index_counter * 3 + 1] = c_y;
-                    nodes_coordinates[index_counter * 3 + 2] = c_z;
-                    ++index_counter;
-
-                    bool   is_x_blocked       = false;
-                    int8_t y_access_direction = 0;
-
-                    bool   is_y_blocked       = false;
-                    int8_t x_access_direction = 0;
-
-                    for(const auto index_s : indices)
-                      {
-                        if(index != index_s)
-                          {
-                            const auto [c_x_s, c_y_s, c_z_s] = index_to_coordinates(index_s, size);
-
-                            if(!is_y_blocked && std::abs(c_x_s - c_x) == 1)
-                              {
-                                if(c_x % 2 == 0)
-                                  {
-                                    is_y_blocked       = true;
-                                    x_access_direction = c_x_s < c_x ? (c_x > 0 ? -1 : 0) : (c_x < (size - 1) ? 1 : 0);
-                                  }
-                              }
-
-                            if(!is_x_blocked && std::abs(c_y_s - c_y) == 1)
-                              {
-                                if(c_y % 2 == 0)
-                                  {
-                                    is_x_blocked       = true;
-                                    y_access_direction = c_y_s < c_y ? (c_y > 0 ? -1 : 0) : (c_y < (size - 1) ? 1 : 0);
-                                  }
-                              }
-                          }
-
-                        if(is_x_blocked && is_y_blocked)
-                          {
-                            break;
-                          }
-                      }
-
-                    if(is_x_blocked && is_y_blocked)
-                      {
-                        if(x_access_direction != 0)
-                          {
-                            source_matrix.set_at(types::INTERSECTION_CELL, c_x + x_access_direction, c_y, c_z);
-                          }
-                        else if(y_access_direction)
-                          {
-                            source_matrix.set_at(types::INTERSECTION_CELL, c_x, c_y + y_access_direction, c_z);
-                          }
-                      }
-
-                    if(!is_x_blocked)
-                      {
-                        bool is_x_line_free = false;
-
-                        for(uint8_t x = 0; x < size; ++x)
-                          {
-                            if(source_matrix.get_at(x, c_y, c_z) == 0)
-                              {
-                                is_x_line_free = true;
-                                break;
-                              }
-                          }
-
-                        if(is_x_line_free)
-                          {
-                            for(uint8_t x = 0; x < size; ++x)
-                              {
-                                const uint8_t& value = source_matrix.get_at(x, c_y, c_z);
-
-                                if(value == 0)
-                                  {
-                                    source_matrix.set_at(types::TRACE_CELL, x, c_y, c_z);
-                                  }
-                                else if(value != types::TERMINAL_CELL)
-                                  {
-                                    source_matrix.set_at(types::INTERSECTION_CELL, x, c_y, c_z);
-                                  }
-                              }
-                          }
-                      }
-
-                    if(!is_y_blocked)
-                      {
-                        bool is_y_line_free = false;
-
-                        for(uint8_t y = 0; y < size; ++y)
-                          {
-                            if(source_matrix.get_at(c_x, y, c_z) == 0)
-                              {
-                                is_y_line_free = true;
-                                break;
-                              }
-                          }
-
-                        if(is_y_line_free)
-                          {
-                            for(uint8_t y = 0; y < size; ++y)
-                              {
-                                const uint8_t& value = source_matrix.get_at(c_x, y, c_z);
-
-                                if(value == 0)
-                                  {
-                                    source_matrix.set_at(types::TRACE_CELL, c_x, y, c_z);
-                                  }
-                                else if(value != types::TERMINAL_CELL)
-                                  {
-                                    source_matrix.set_at(types::INTERSECTION_CELL, c_x, y, c_z);
-                                  }
-                              }
-                          }
-                      }
-
-                    bool is_z_line_free = false;
-
-                    for(uint8_t z = 0; z < depth; ++z)
-                      {
-                        if(source_matrix.get_at(c_x, c_y, z) == 0)
-                          {
-                            is_z_line_free = true;
-                            break;
-                          }
-                      }
-
-                    if(is_z_line_free)
-                      {
-                        for(uint8_t z = 0; z < depth; ++z)
-                          {
-                            const uint8_t& value = source_matrix.get_at(c_x, c_y, z);
-
-                            if(value == 0)
-                              {
-                                source_matrix.set_at(types::TRACE_CELL, c_x, c_y, z);
-                              }
-                            else if(value != types::TERMINAL_CELL)
-                              {
-                                source_matrix.set_at(types::INTERSECTION_VIA_CELL, c_x, c_y, z);
-                              }
-                          }
-                      }
-                  }
+      while(!fits(number_of_points))
+        {
+          --number_of_points;
+        }
 
-                const auto [source_graph, nodes]                               = transform::matrix_to_graph(source_matrix, index_to_coordinates(indices[0], size));
-                const std::vector<std::pair<uint32_t, uint32_t>> mst           = algorithms::dijkstra_kruskal_greedy(source_graph);
-                const matrix::Matrix                             target_matrix = transform::mst_to_matrix({ size, size, depth }, mst, nodes);
+      std::cerr << "The number of combinations of " << uint32_t(settings.m_max_number_of_points) << " points doesn't fit 128 bits." << std::endl;
+      std::cout << "Using " << uint32_t(number_of_points) << " points at most instead." << std::endl;
 
-                counter.fetch_add(1);
+      settings.m_max_number_of_points = number_of_points;
+      settings.m_min_number_of_points = std::min(settings.m_min_number_of_points, number_of_points);
+    }
 
-                const std::string matrix_name = "s" + std::to_string(size) + "_d" + std::to_string(depth) + "_p" + std::to_string(i) + "_n" + std::to_string(counter) + ".npy";
+  std::cout << "  - Size                : " << uint32_t(settings.m_size) << std::endl;
+  std::cout << "  - Depth               : " << uint32_t(settings.m_depth) << std::endl;
+  std::cout << "  - Min number of points: " << uint32_t(settings.m_min_number_of_points) << std::endl;
+  std::cout << "  - Max number of points: " << uint32_t(settings.m_max_number_of_points) << std::endl;
+  std::cout << "  - Desired combinations: " << settings.m_desired_combinations << std::endl;
+  std::cout << "  - Sampling            : " << (settings.m_random_sampling ? "Random, seed " + std::to_string(settings.m_seed) : std::string("Stride")) << std::endl;
+  std::cout << "  - Threads             : " << settings.m_threads << std::endl;
+  std::cout << "  - Shard               : " << settings.m_shard << " of " << settings.m_shards << std::endl;
+  std::cout << "  - Tile size           : " << (settings.m_tile_size == 0 ? std::string("off") : std::to_string(settings.m_tile_size)) << std::endl;
+  std::cout << "  - Tile overlap        : " << uint32_t(settings.m_tile_overlap) << std::endl;
+  std::cout << "  - Layer directions    : " << layer_directions_name(settings.m_layer_directions) << std::endl;
+  std::cout << "\n";
 
-                numpy::save_as<uint8_t>(source_dir / matrix_name, reinterpret_cast<char*>(source_matrix.data()), { depth, size, size });
-                numpy::save_as<uint8_t>(target_dir / matrix_name, reinterpret_cast<const char*>(target_matrix.data()), { depth, size, size });
-                numpy::save_as<uint8_t>(nodes_dir / matrix_name, reinterpret_cast<const char*>(nodes_coordinates.data()), { max_number_of_points, 3 });
+  /** A resumed run keeps the samples of the done ranges, so it must have the settings they were made with */
+  bool resumed = false;
 
-                progress_bar.step();
-              }
-          };
+  if(resume)
+    {
+      if(std::filesystem::exists(directories.m_root / "Manifest.ini"))
+        {
+          const ini::Config manifest = ini::parse(directories.m_root / "Manifest.ini");
+
+          for(const auto& [key, value] : manifest_settings(settings))
+            {
+              if(!manifest.at("Manifest").check_key(key) || manifest.at("Manifest").get_as<std::string>(key) != value)
+                {
+                  std::cerr << key << " differs from the run being resumed in " << directories.m_root << "." << std::endl;
+                  return 1;
+                }
+            }
+
+          resumed = true;
+          std::cout << "Resuming the run in " << directories.m_root << "." << std::endl;
+        }
+      else
+        {
+          std::cout << "Nothing to resume in " << directories.m_root << ", starting anew." << std::endl;
+        }
+    }
 
-          threads[j] = std::thread(worker);
+  for(const auto& dir : { directories.m_source, directories.m_target, directories.m_nodes, directories.m_graph, directories.m_features, directories.m_journal })
+    {
+      if(!resumed && std::filesystem::exists(dir))
+        {
+          std::filesystem::remove_all(dir);
         }
 
-      for(auto& thread : threads)
+      if((dir != directories.m_graph || settings.m_export_graph) && (dir != directories.m_features || settings.m_export_features))
         {
-          thread.join();
+          std::filesystem::create_directories(dir);
         }
     }
 
+  /** The list of samples is written once the run is done */
+  std::filesystem::remove(directories.m_root / "Manifest.csv");
+  write_settings(settings, directories);
+
+  /** Small grids keep the narrow coordinates */
+  const uint64_t unconnected_samples = settings.m_size <= UINT8_MAX && settings.m_depth <= UINT8_MAX ? generate<uint8_t>(settings, directories) : generate<uint16_t>(settings, directories);
+
+  if(unconnected_samples != 0)
+    {
+      std::cout << "  - Skipped samples: " << unconnected_samples << ", the trace terrain doesn't connect their terminals." << std::endl;
+    }
+
   return 0;
-}
\ No newline at end of file
+}
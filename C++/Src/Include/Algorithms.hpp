@@ -2,14 +2,36 @@
 #define __ALGORITHMS_HPP__
 
 #include <cstdint>
+#include <memory_resource>
+#include <tuple>
 #include <vector>
 
 #include "Include/Graph.hpp"
 #include "Include/Matrix.hpp"
+#include "Include/Utilis.hpp"
 
 namespace algorithms
 {
 
+/**
+ * @brief Buffers of the solver that are cleared and reused between calls, one per thread.
+ * The maps and sets of a call keep their hashing and order, their memory comes from the
+ * pool of the workspace and goes back to it at the end of the call.
+ *
+ */
+struct Workspace
+{
+  std::vector<uint32_t>                      m_dist;      ///< Distances of the shortest paths search.
+  std::vector<std::vector<uint32_t>>         m_prev;      ///< Predecessors of the shortest paths search.
+  std::vector<graph::Edge>                   m_queue;     ///< Heap of the shortest paths search.
+  std::vector<uint32_t>                      m_terminals; ///< Terminals of the graph in a fixed order.
+  std::vector<uint32_t>                      m_parent;    ///< Parents of the union-find.
+  std::vector<uint32_t>                      m_rank;      ///< Ranks of the union-find.
+  std::vector<graph::Edge>                   m_mst;       ///< Edges of the tree being built.
+  std::vector<std::pair<uint32_t, uint32_t>> m_tree;      ///< The resulting tree.
+  std::pmr::unsynchronized_pool_resource     m_memory;    ///< Pool of the path merge map, the merge blocks, the paths and the tree degrees.
+};
+
 /**
  * @brief Finds MST using Dijkstra and Kruskal methods. Greedy version.
  *
@@ -19,6 +41,48 @@ namespace algorithms
 std::vector<std::pair<uint32_t, uint32_t>>
 dijkstra_kruskal_greedy(const graph::Graph& graph);
 
+/**
+ * @brief Same as dijkstra_kruskal_greedy, runs on the buffers of the workspace.
+ *
+ * @param graph The graph to use to find MST.
+ * @param workspace The buffers to reuse.
+ * @return const std::vector<std::pair<uint32_t, uint32_t>>& The tree, valid until the next call with the workspace.
+ */
+const std::vector<std::pair<uint32_t, uint32_t>>&
+dijkstra_kruskal_greedy(const graph::Graph& graph, Workspace& workspace);
+
+/**
+ * @brief Checks that a tree connects all terminals of a sample. Terminals that the trace
+ * terrain can't reach are missing from the graph, so their number is checked as well.
+ *
+ * @param graph The graph the tree was found on.
+ * @param tree The tree.
+ * @param number_of_terminals The number of terminals of the sample.
+ * @return bool
+ */
+bool
+spans_terminals(const graph::Graph& graph, const std::vector<std::pair<uint32_t, uint32_t>>& tree, const std::size_t number_of_terminals);
+
+/**
+ * @brief Finds MST of a large graph tile by tile. Terminals are grouped by square tiles
+ * of the grid, the subtree of every tile is found in parallel on the nodes within the
+ * tile and its overlap, and then the subtrees are stitched together by shortest paths.
+ * The tiles are jobs of the pool, so idle workers help with them.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param graph The graph to use to find MST.
+ * @param nodes The coordinates of the nodes.
+ * @param tile_size The size of a tile.
+ * @param overlap The number of cells a tile's subgraph extends past its borders.
+ * @param pool The pool to solve the tiles on.
+ * @param worker The worker of the pool calling.
+ * @param workspaces The buffers of the tiles, one per worker of the pool.
+ * @return std::vector<std::pair<uint32_t, uint32_t>>
+ */
+template <typename Extent>
+std::vector<std::pair<uint32_t, uint32_t>>
+tiled_dijkstra_kruskal_greedy(const graph::Graph& graph, const std::vector<matrix::Coordinates<Extent>>& nodes, const uint32_t tile_size, const uint32_t overlap, utils::TaskPool& pool, const std::size_t worker, std::vector<Workspace>& workspaces);
+
 } // namespace algorithms
 
 #endif
@@ -0,0 +1,155 @@
+#ifndef __BIT_PLANE_MATRIX_HPP__
+#define __BIT_PLANE_MATRIX_HPP__
+
+#include <cstdint>
+#include <vector>
+
+#include "Include/Matrix.hpp"
+
+namespace matrix
+{
+
+/**
+ * @brief Matrix of cell classes stored as one bit-plane per class. Every plane packs the
+ * rows along x into 64-bit words, so row checks and fills work on whole words. Empty cells
+ * have no plane.
+ *
+ * @tparam Extent The type of a dimension and a coordinate, uint8_t, uint16_t or uint32_t.
+ */
+template <typename Extent>
+class BasicBitPlaneMatrix
+{
+public:
+  using Shape = BasicShape<Extent>;
+
+public:
+  /** =============================== CONSTRUCTORS ================================= */
+
+  /**
+   * @brief Constructs an empty bit-plane matrix with the specified shape.
+   *
+   * @param shape Shape structure containing the dimensions of the matrix.
+   */
+  BasicBitPlaneMatrix(const Shape& shape = {});
+
+  /**
+   * @brief Constructs a bit-plane matrix from the byte layout.
+   *
+   * @param matrix The matrix to convert.
+   */
+  explicit BasicBitPlaneMatrix(const BasicMatrix<Extent>& matrix);
+
+public:
+  /** =============================== PUBLIC METHODS =============================== */
+
+  /**
+   * @brief Returns the shape of the matrix.
+   *
+   * @return const Shape&
+   */
+  const Shape&
+  shape() const;
+
+  /**
+   * @brief Retrieves the class of the cell at the given (x, y, z) coordinates.
+   *
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @param z Z-coordinate (depth).
+   * @return uint8_t The class of the cell, 0 if it is empty.
+   */
+  uint8_t
+  get_at(const Extent x, const Extent y, const Extent z) const;
+
+  /**
+   * @brief Sets the class of the cell at the given (x, y, z) coordinates.
+   *
+   * @param value The class to set, 0 to clear the cell.
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @param z Z-coordinate (depth).
+   */
+  void
+  set_at(const uint8_t value, const Extent x, const Extent y, const Extent z);
+
+  /**
+   * @brief Fills the row along x if it still has an empty cell. Empty cells become trace
+   * cells and the other ones, except terminals, become crossings.
+   *
+   * @param y Y-coordinate of the row.
+   * @param z Z-coordinate of the row.
+   * @param crossing_value The class of a cell where the row crosses another line.
+   */
+  void
+  fill_row(const Extent y, const Extent z, const uint8_t crossing_value);
+
+  /**
+   * @brief Fills the column along y, same as fill_row.
+   *
+   * @param x X-coordinate of the column.
+   * @param z Z-coordinate of the column.
+   * @param crossing_value The class of a cell where the column crosses another line.
+   */
+  void
+  fill_column(const Extent x, const Extent z, const uint8_t crossing_value);
+
+  /**
+   * @brief Fills the pillar along z, same as fill_row.
+   *
+   * @param x X-coordinate of the pillar.
+   * @param y Y-coordinate of the pillar.
+   * @param crossing_value The class of a cell where the pillar crosses another line.
+   */
+  void
+  fill_pillar(const Extent x, const Extent y, const uint8_t crossing_value);
+
+  /**
+   * @brief Writes the classes into the byte layout, overwriting the matrix's content.
+   *
+   * @param matrix The matrix of the same shape to write to.
+   */
+  void
+  to_matrix(BasicMatrix<Extent>& matrix) const;
+
+  /**
+   * @brief Converts the classes to the byte layout.
+   *
+   * @return BasicMatrix<Extent>
+   */
+  BasicMatrix<Extent>
+  to_matrix() const;
+
+private:
+  /** =============================== PRIVATE METHODS ============================== */
+
+  /**
+   * @brief Returns the index of the first word of the row along x.
+   *
+   */
+  std::size_t
+  row_of(const Extent y, const Extent z) const;
+
+  /**
+   * @brief Fills a line across the rows, bit by bit. The cells of the line share the bit
+   * and the accessor returns the word of the i-th one.
+   *
+   */
+  template <typename Word>
+  void
+  fill_cells(const std::size_t length, Word&& word, const uint64_t bit, const uint8_t crossing_value);
+
+private:
+  static constexpr std::size_t s_planes = 5; ///< Number of non-empty classes.
+
+  Shape                        m_shape;            ///< Holds the dimensions of the matrix.
+  std::size_t                  m_words;            ///< Number of words per row.
+  std::vector<uint64_t>        m_planes[s_planes]; ///< Cells of every class, plane i holds class i + 1.
+};
+
+using BitPlaneMatrix   = BasicBitPlaneMatrix<uint8_t>;
+using BitPlaneMatrix16 = BasicBitPlaneMatrix<uint16_t>;
+using BitPlaneMatrix32 = BasicBitPlaneMatrix<uint32_t>;
+
+} // namespace matrix
+
+#endif
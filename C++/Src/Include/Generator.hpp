@@ -1,6 +1,9 @@
 #ifndef __GENERATOR_HPP__
 #define __GENERATOR_HPP__
 
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <tuple>
 #include <vector>
 
@@ -8,15 +11,118 @@ namespace gen
 {
 
 /**
- * @brief Computes nCr (combinations count) for large numbers
+ * @brief Rank of a combination and size of a combination space. Grids of a few thousand
+ * cells with ten and more points already have more combinations than 64 bits can count.
+ *
+ */
+using Rank = unsigned __int128;
+
+/**
+ * @brief Computes nCr (combinations count) for large numbers, throws std::overflow_error if
+ * it doesn't fit a rank.
  *
  * @param n The number of items.
  * @param r The number of items being chosen at a time.
- * @return unsigned long long
+ * @return Rank
  */
-uint64_t
+Rank
 nCr(uint32_t n, uint32_t r);
 
+/**
+ * @brief Pascal's triangle of binomial coefficients nCr for n up to the length and r up to
+ * the number of points, built once and shared by the iterators that unrank combinations.
+ * A triangle past 64 MiB isn't kept, its coefficients are computed with gen::nCr instead.
+ *
+ */
+class BinomialTable
+{
+public:
+  /** =============================== CONSTRUCTORS ================================= */
+
+  /**
+   * @brief Builds the table with the Pascal recurrence, throws std::overflow_error if a
+   * coefficient doesn't fit a rank. A table too large to keep is left empty.
+   *
+   * @param length The length of the combination sequence.
+   * @param number_of_points The largest number of points in a combination, the table serves
+   * every lower number too.
+   */
+  BinomialTable(const uint32_t length, const uint8_t number_of_points);
+
+public:
+  /** =============================== PUBLIC METHODS =============================== */
+
+  /**
+   * @brief Returns nCr from the table, or computes it if the table is empty.
+   *
+   * @param n The number of items, up to the length.
+   * @param r The number of items being chosen, up to the number of points.
+   * @return Rank
+   */
+  Rank
+  nCr(const uint32_t n, const uint8_t r) const;
+
+  /**
+   * @brief Writes the combination of the given lexicographical rank. Every position is
+   * found by a binary search in a column of the table.
+   *
+   * @param combination The combination, sized to its number of points, at most the one of
+   * the table.
+   * @param rank The rank, less than the number of combinations.
+   */
+  void
+  unrank(std::vector<uint32_t>& combination, Rank rank) const;
+
+  /**
+   * @brief Moves the combination forward by the step in lexicographical order, in place.
+   * A step of one is the plain successor, longer steps are added to the rank of the
+   * shortest suffix that absorbs them and only that suffix is unranked again.
+   *
+   * @param combination The combination, sized to its number of points, at most the one of
+   * the table. Its rank plus the step must stay in range.
+   * @param step The number of combinations to skip.
+   */
+  void
+  advance(std::vector<uint32_t>& combination, const Rank step) const;
+
+  uint32_t
+  length() const;
+
+  uint8_t
+  number_of_points() const;
+
+private:
+  /** =============================== PRIVATE METHODS ============================== */
+
+  /**
+   * @brief Writes the points from the position on, the rank is taken among the
+   * combinations that share the points before it.
+   *
+   * @param combination The combination.
+   * @param rank The rank of the suffix.
+   * @param position The first position to write.
+   */
+  void
+  unrank(std::vector<uint32_t>& combination, Rank rank, const uint8_t position) const;
+
+  /**
+   * @brief Returns the smallest n' up to n whose n'Cr is at least the value, by a binary
+   * search in the column of r.
+   *
+   * @param r The number of items being chosen.
+   * @param n The largest number of items.
+   * @param value The value, at most nCr.
+   * @return uint32_t
+   */
+  uint32_t
+  lower_bound(const uint8_t r, const uint32_t n, const Rank value) const;
+
+private:
+  uint32_t              m_length;           ///< Length of the combination sequence.
+  uint8_t               m_number_of_points; ///< Largest number of points of the combinations.
+  std::vector<Rank>     m_table;            ///< Columns of nCr over n, one per r. Empty past the size limit.
+};
+
 class GeneratorItr
 {
 public:
@@ -30,7 +136,18 @@ public:
    * @param step The step size between combinations.
    * @param x The inital combination.
    */
-  GeneratorItr(const uint32_t length, const uint8_t number_of_points, const uint64_t step, const uint64_t start, const uint64_t end);
+  GeneratorItr(const uint32_t length, const uint8_t number_of_points, const Rank step, const Rank start, const Rank end);
+
+  /**
+   * @brief Constructor for GeneratorItr over a shared table.
+   *
+   * @param table The binomial table of the length, for the number of points or more.
+   * @param number_of_points The number of points in the combination.
+   * @param step The step size between combinations.
+   * @param start The rank of the initial combination.
+   * @param end The rank past the last combination.
+   */
+  GeneratorItr(std::shared_ptr<const BinomialTable> table, const uint8_t number_of_points, const Rank step, const Rank start, const Rank end);
 
   /** =============================== OPERATORS ==================================== */
 
@@ -45,9 +162,9 @@ public:
   /**
    * @brief Dereference operator to access the current combination.
    *
-   * @return std::vector<uint32_t>
+   * @return std::span<const uint32_t> The combination, valid until the iterator moves.
    */
-  std::vector<uint32_t>
+  std::span<const uint32_t>
   operator*() const;
 
   /**
@@ -61,12 +178,140 @@ public:
   operator<(const GeneratorItr& other) const;
 
 private:
-  uint8_t               m_number_of_points; ///< Number of points in each combination.
+  std::shared_ptr<const BinomialTable> m_table; ///< Unranks the combinations.
+  Rank                                 m_step;  ///<  Size between combinations
+  Rank                                 m_start;
+  Rank                                 m_end;
+  std::vector<uint32_t>                m_combination; ///< The current combination.
+};
+
+/**
+ * @brief Counter-based random stream. A draw depends only on the seed, the stream and its
+ * position in the stream, so streams may be spread over threads in any way and still
+ * reproduce the same numbers.
+ *
+ */
+class CounterRng
+{
+public:
+  /** =============================== CONSTRUCTORS ================================= */
+
+  /**
+   * @brief Constructs the stream.
+   *
+   * @param seed The seed shared by all streams.
+   * @param stream The number of the stream.
+   */
+  CounterRng(const uint64_t seed, const uint64_t stream);
+
+public:
+  /** =============================== PUBLIC METHODS =============================== */
+
+  /**
+   * @brief Returns the next number of the stream.
+   *
+   * @return uint64_t
+   */
+  uint64_t
+  operator()();
+
+  /**
+   * @brief Returns the next number of the stream uniformly distributed in [0, bound).
+   *
+   * @param bound The bound, greater than zero.
+   * @return uint64_t
+   */
+  uint64_t
+  below(const uint64_t bound);
+
+private:
+  uint64_t m_key;         ///< Key of the stream.
+  uint64_t m_counter = 0; ///< Position in the stream.
+};
+
+/**
+ * @brief Draws a uniform random combination with Floyd's algorithm, with one draw per
+ * point. The points are sorted.
+ *
+ * @param combination The combination, sized to the number of points.
+ * @param length The length of the combination sequence.
+ * @param random The random stream.
+ */
+void
+random_combination(std::vector<uint32_t>& combination, const uint32_t length, CounterRng& random);
+
+class RandomItr
+{
+public:
+  /** =============================== CONSTRUCTORS ================================= */
+
+  /**
+   * @brief Constructor for RandomItr. Every sample is drawn from its own stream of the seed,
+   * so a sample doesn't depend on how the samples are split among iterators.
+   *
+   * @param length The length of the combination sequence.
+   * @param number_of_points The number of points in the combination.
+   * @param seed The seed of the samples.
+   * @param start The number of the first sample.
+   * @param end The number past the last sample.
+   */
+  RandomItr(const uint32_t length, const uint8_t number_of_points, const uint64_t seed, const uint64_t start, const uint64_t end);
+
+  /** =============================== OPERATORS ==================================== */
+
+  /**
+   * @brief Increment operator to draw the next sample.
+   *
+   * @return RandomItr&
+   */
+  RandomItr&
+  operator++();
+
+  /**
+   * @brief Dereference operator to access the current combination.
+   *
+   * @return std::span<const uint32_t> The combination, valid until the iterator moves.
+   */
+  std::span<const uint32_t>
+  operator*() const;
+
+  /**
+   * @brief Less comparison operator.
+   *
+   * @param other The other iterator to compare with.
+   * @return true
+   * @return false
+   */
+  bool
+  operator<(const RandomItr& other) const;
+
+  /** =============================== PUBLIC METHODS =============================== */
+
+  /**
+   * @brief Returns the number of the current sample.
+   *
+   * @return uint64_t
+   */
+  uint64_t
+  sample() const;
+
+private:
+  /** =============================== PRIVATE METHODS ============================== */
+
+  /**
+   * @brief Draws the combination of the current sample.
+   *
+   */
+  void
+  draw();
+
+private:
   uint32_t              m_length;           ///< Length of the combination sequence.
-  uint64_t              m_step;             ///<  Size between combinations
-  uint64_t              m_start;
-  uint64_t              m_end;
-  std::vector<uint32_t> m_combination; ///< The current combination.
+  uint8_t               m_number_of_points; ///< Number of points in each combination.
+  uint64_t              m_seed;             ///< Seed of the samples.
+  uint64_t              m_sample;           ///< Number of the current sample.
+  uint64_t              m_end;              ///< Number past the last sample.
+  std::vector<uint32_t> m_combination;      ///< The current combination.
 };
 
 } // namespace gen
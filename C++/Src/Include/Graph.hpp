@@ -35,6 +35,15 @@ public:
 
   void
   add_edge(uint32_t weight, uint32_t source, uint32_t destination);
+
+  /**
+   * @brief Removes all nodes, edges and terminals. The node list and the adjacency lists
+   * keep their capacity.
+   *
+   */
+  void
+  clear();
+
   const std::vector<std::vector<Edge>>&
   get_adj() const;
 
@@ -43,6 +52,7 @@ public:
 
 private:
   std::vector<std::vector<Edge>> m_adj;
+  std::vector<std::vector<Edge>> m_spare;
   std::unordered_set<uint32_t>   m_terminals;
 };
 
@@ -0,0 +1,36 @@
+#ifndef __KERNELS_HPP__
+#define __KERNELS_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kernels
+{
+
+/**
+ * @brief Checks if a contiguous span of cells holds the value. Written as blocks without
+ * early exit, so that it vectorizes for the target of the build.
+ *
+ * @param data The first cell.
+ * @param length The number of cells.
+ * @param value The value to look for.
+ * @return true
+ * @return false
+ */
+bool
+contains(const uint8_t* data, const std::size_t length, const uint8_t value);
+
+/**
+ * @brief Fills a contiguous line of the terrain. Empty cells become trace cells and the
+ * other ones, except terminals, become crossings.
+ *
+ * @param data The first cell.
+ * @param length The number of cells.
+ * @param crossing_value The value of a cell where the line crosses another one.
+ */
+void
+fill_line(uint8_t* data, const std::size_t length, const uint8_t crossing_value);
+
+} // namespace kernels
+
+#endif
@@ -1,23 +1,531 @@
 #ifndef __MATRIX_HPP__
 #define __MATRIX_HPP__
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace matrix
 {
 
-struct Shape
+/**
+ * @brief Dimensions of a matrix.
+ *
+ * @tparam Extent The type of a dimension, uint8_t, uint16_t or uint32_t.
+ */
+template <typename Extent>
+struct BasicShape
 {
-  uint8_t m_x = 0;
-  uint8_t m_y = 0;
-  uint8_t m_z = 0;
+  Extent m_x = 0;
+  Extent m_y = 0;
+  Extent m_z = 0;
 };
 
-class Matrix
+/**
+ * @brief Coordinates of a cell, (x, y, z).
+ *
+ * @tparam Extent The type of a coordinate.
+ */
+template <typename Extent>
+using Coordinates = std::tuple<Extent, Extent, Extent>;
+
+/**
+ * @brief Access policy that checks every index and throws std::out_of_range.
+ *
+ */
+struct CheckedAccess
+{
+  static constexpr bool s_is_checked = true;
+};
+
+/**
+ * @brief Access policy without any index checks.
+ *
+ */
+struct UncheckedAccess
+{
+  static constexpr bool s_is_checked = false;
+};
+
+/** Debug builds check every access of views, release builds don't */
+#ifdef DLRS_DEBUG
+using DefaultAccess = CheckedAccess;
+#else
+using DefaultAccess = UncheckedAccess;
+#endif
+
+/**
+ * @brief Strided line of cells: a row, a column or a pillar of a matrix.
+ *
+ * @tparam Tp The cell type, uint8_t or const uint8_t.
+ * @tparam Access The access policy.
+ */
+template <typename Tp, typename Access = DefaultAccess>
+class Line
 {
+public:
+  /**
+   * @brief Forward iterator over the cells of the line.
+   *
+   */
+  class Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::remove_const_t<Tp>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = Tp*;
+    using reference         = Tp&;
+
+    Iterator() = default;
+
+    Iterator(Tp* cell, const std::ptrdiff_t stride)
+        : m_cell(cell), m_stride(stride)
+    {
+    }
+
+    reference
+    operator*() const
+    {
+      return *m_cell;
+    }
+
+    Iterator&
+    operator++()
+    {
+      m_cell += m_stride;
+      return *this;
+    }
+
+    Iterator
+    operator++(int)
+    {
+      Iterator copy = *this;
+      m_cell += m_stride;
+      return copy;
+    }
+
+    bool
+    operator==(const Iterator& other) const
+    {
+      return m_cell == other.m_cell;
+    }
+
+  private:
+    Tp*            m_cell   = nullptr; ///< The current cell.
+    std::ptrdiff_t m_stride = 0;       ///< Distance between cells.
+  };
+
+public:
+  Line(Tp* first, const std::ptrdiff_t stride, const std::size_t size)
+      : m_first(first), m_stride(stride), m_size(size)
+  {
+  }
+
+  /**
+   * @brief Returns the i-th cell of the line.
+   *
+   * @param i The position along the line.
+   * @return Tp&
+   */
+  Tp&
+  operator[](const std::size_t i) const
+  {
+    if constexpr(Access::s_is_checked)
+      {
+        if(i >= m_size)
+          {
+            throw std::out_of_range("Out of range");
+          }
+      }
+
+    return m_first[std::ptrdiff_t(i) * m_stride];
+  }
+
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Returns the first cell, the line is contiguous if its stride is 1.
+   *
+   * @return Tp*
+   */
+  Tp*
+  data() const
+  {
+    return m_first;
+  }
+
+  std::ptrdiff_t
+  stride() const
+  {
+    return m_stride;
+  }
+
+  Iterator
+  begin() const
+  {
+    return Iterator(m_first, m_stride);
+  }
+
+  Iterator
+  end() const
+  {
+    return Iterator(m_first + std::ptrdiff_t(m_size) * m_stride, m_stride);
+  }
+
+private:
+  Tp*            m_first;  ///< The first cell.
+  std::ptrdiff_t m_stride; ///< Distance between cells.
+  std::size_t    m_size;   ///< Number of cells.
+};
+
+/**
+ * @brief Non-owning view of matrix data with precomputed strides. The access policy
+ * decides whether indices are checked.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @tparam Tp The cell type, uint8_t or const uint8_t.
+ * @tparam Access The access policy.
+ */
+template <typename Extent, typename Tp = uint8_t, typename Access = DefaultAccess>
+class BasicView
+{
+public:
+  BasicView(Tp* data, const BasicShape<Extent>& shape)
+      : m_data(data), m_shape(shape), m_x_stride(shape.m_z), m_y_stride(std::size_t(shape.m_y) * shape.m_z)
+  {
+  }
+
+  /**
+   * @brief Returns the cell at the given (x, y, z) coordinates.
+   *
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @param z Z-coordinate (depth).
+   * @return Tp&
+   */
+  Tp&
+  operator()(const Extent x, const Extent y, const Extent z) const
+  {
+    check(x, y, z);
+    return m_data[y * m_y_stride + x * m_x_stride + (m_shape.m_z - z - 1)];
+  }
+
+  /**
+   * @brief Returns the row of cells along x.
+   *
+   * @param y Y-coordinate of the row.
+   * @param z Z-coordinate of the row.
+   * @return Line<Tp, Access>
+   */
+  Line<Tp, Access>
+  row(const Extent y, const Extent z) const
+  {
+    check(0, y, z);
+    return Line<Tp, Access>(m_data + y * m_y_stride + (m_shape.m_z - z - 1), m_x_stride, m_shape.m_x);
+  }
+
+  /**
+   * @brief Returns the column of cells along y.
+   *
+   * @param x X-coordinate of the column.
+   * @param z Z-coordinate of the column.
+   * @return Line<Tp, Access>
+   */
+  Line<Tp, Access>
+  column(const Extent x, const Extent z) const
+  {
+    check(x, 0, z);
+    return Line<Tp, Access>(m_data + x * m_x_stride + (m_shape.m_z - z - 1), m_y_stride, m_shape.m_y);
+  }
+
+  /**
+   * @brief Returns the pillar of cells along z, from the bottom layer up.
+   *
+   * @param x X-coordinate of the pillar.
+   * @param y Y-coordinate of the pillar.
+   * @return Line<Tp, Access>
+   */
+  Line<Tp, Access>
+  pillar(const Extent x, const Extent y) const
+  {
+    check(x, y, 0);
+    return Line<Tp, Access>(m_data + y * m_y_stride + x * m_x_stride + (m_shape.m_z - 1), -1, m_shape.m_z);
+  }
+
+  const BasicShape<Extent>&
+  shape() const
+  {
+    return m_shape;
+  }
+
+private:
+  void
+  check(const Extent x, const Extent y, const Extent z) const
+  {
+    if constexpr(Access::s_is_checked)
+      {
+        if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
+          {
+            throw std::out_of_range("Out of range");
+          }
+      }
+  }
+
+private:
+  Tp*                m_data;     ///< The viewed data.
+  BasicShape<Extent> m_shape;    ///< Shape of the viewed matrix.
+  std::size_t        m_x_stride; ///< Distance between neighbours along x.
+  std::size_t        m_y_stride; ///< Distance between neighbours along y.
+};
+
+/**
+ * @brief Memory layout with depth as the innermost and reversed axis, then x, then y. This
+ * is the layout of the saved numpy arrays.
+ *
+ */
+class RowMajorLayout
+{
+public:
+  RowMajorLayout() = default;
+
+  template <typename Extent>
+  explicit RowMajorLayout(const BasicShape<Extent>& shape)
+      : m_x(shape.m_x), m_y(shape.m_y), m_z(shape.m_z)
+  {
+  }
+
+  /**
+   * @brief Returns the number of cells to allocate.
+   *
+   */
+  std::size_t
+  size() const
+  {
+    return std::size_t(m_x) * m_y * m_z;
+  }
+
+  /**
+   * @brief Returns the position of the cell in memory.
+   *
+   */
+  std::size_t
+  index(const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+    return std::size_t(y) * m_y * m_z + std::size_t(x) * m_z + (m_z - z - 1);
+  }
+
+  /**
+   * @brief Calls the function with the position and the coordinates of every cell, in memory order.
+   *
+   */
+  template <typename Function>
+  void
+  for_each(Function&& function) const
+  {
+    std::size_t i = 0;
+
+    for(uint32_t y = 0; y < m_y; ++y)
+      {
+        for(uint32_t x = 0; x < m_x; ++x)
+          {
+            for(uint32_t z = m_z; z-- > 0;)
+              {
+                function(i++, x, y, z);
+              }
+          }
+      }
+  }
+
+private:
+  uint32_t m_x = 0;
+  uint32_t m_y = 0;
+  uint32_t m_z = 0;
+};
+
+/**
+ * @brief Z-order memory layout. The bits of the coordinates are interleaved, every axis
+ * takes part only while it has bits left, so flat terrains don't pad the depth.
+ *
+ */
+class MortonLayout
+{
+public:
+  MortonLayout() = default;
+
+  template <typename Extent>
+  explicit MortonLayout(const BasicShape<Extent>& shape)
+      : m_extent{ shape.m_x, shape.m_y, shape.m_z }
+  {
+    for(std::size_t axis = 0; axis < 3; ++axis)
+      {
+        while((uint64_t(1) << m_bits[axis]) < m_extent[axis])
+          {
+            ++m_bits[axis];
+          }
+      }
+  }
+
+  std::size_t
+  size() const
+  {
+    return m_extent[0] == 0 || m_extent[1] == 0 || m_extent[2] == 0 ? 0 : std::size_t(1) << (m_bits[0] + m_bits[1] + m_bits[2]);
+  }
+
+  std::size_t
+  index(const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+    const uint32_t coordinates[3] = { x, y, z };
+    std::size_t    index          = 0;
+    uint32_t       position       = 0;
+
+    for(uint32_t bit = 0; bit < m_bits[0] || bit < m_bits[1] || bit < m_bits[2]; ++bit)
+      {
+        for(std::size_t axis = 0; axis < 3; ++axis)
+          {
+            if(bit < m_bits[axis])
+              {
+                index |= std::size_t(coordinates[axis] >> bit & 1) << position++;
+              }
+          }
+      }
+
+    return index;
+  }
+
+  template <typename Function>
+  void
+  for_each(Function&& function) const
+  {
+    for(std::size_t i = 0, end = size(); i < end; ++i)
+      {
+        uint32_t    coordinates[3] = { 0, 0, 0 };
+        std::size_t rest           = i;
+
+        for(uint32_t bit = 0; rest != 0; ++bit)
+          {
+            for(std::size_t axis = 0; axis < 3; ++axis)
+              {
+                if(bit < m_bits[axis])
+                  {
+                    coordinates[axis] |= uint32_t(rest & 1) << bit;
+                    rest >>= 1;
+                  }
+              }
+          }
+
+        if(coordinates[0] < m_extent[0] && coordinates[1] < m_extent[1] && coordinates[2] < m_extent[2])
+          {
+            function(i, coordinates[0], coordinates[1], coordinates[2]);
+          }
+      }
+  }
+
+private:
+  uint32_t m_extent[3] = { 0, 0, 0 }; ///< Number of cells along each axis.
+  uint32_t m_bits[3]   = { 0, 0, 0 }; ///< Number of bits of a coordinate along each axis.
+};
+
+/**
+ * @brief Memory layout of small bricks. Bricks are stored one after another, the cells of
+ * a brick are stored row-major within it. Bricks never exceed the matrix along an axis.
+ *
+ * @tparam Side The side of a brick.
+ */
+template <uint32_t Side = 4>
+class BrickLayout
+{
+public:
+  BrickLayout() = default;
+
+  template <typename Extent>
+  explicit BrickLayout(const BasicShape<Extent>& shape)
+      : m_extent{ shape.m_x, shape.m_y, shape.m_z }
+  {
+    for(std::size_t axis = 0; axis < 3; ++axis)
+      {
+        m_side[axis]   = std::min(Side, m_extent[axis]);
+        m_bricks[axis] = m_side[axis] == 0 ? 0 : (m_extent[axis] + m_side[axis] - 1) / m_side[axis];
+      }
+  }
+
+  std::size_t
+  size() const
+  {
+    return std::size_t(m_bricks[0]) * m_bricks[1] * m_bricks[2] * m_side[0] * m_side[1] * m_side[2];
+  }
+
+  std::size_t
+  index(const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+    const std::size_t brick = (std::size_t(y / m_side[1]) * m_bricks[0] + x / m_side[0]) * m_bricks[2] + z / m_side[2];
+    const std::size_t cell  = (std::size_t(y % m_side[1]) * m_side[0] + x % m_side[0]) * m_side[2] + z % m_side[2];
+
+    return brick * m_side[0] * m_side[1] * m_side[2] + cell;
+  }
+
+  template <typename Function>
+  void
+  for_each(Function&& function) const
+  {
+    std::size_t i = 0;
+
+    for(uint32_t b_y = 0; b_y < m_bricks[1]; ++b_y)
+      {
+        for(uint32_t b_x = 0; b_x < m_bricks[0]; ++b_x)
+          {
+            for(uint32_t b_z = 0; b_z < m_bricks[2]; ++b_z)
+              {
+                for(uint32_t c_y = 0; c_y < m_side[1]; ++c_y)
+                  {
+                    for(uint32_t c_x = 0; c_x < m_side[0]; ++c_x)
+                      {
+                        for(uint32_t c_z = 0; c_z < m_side[2]; ++c_z, ++i)
+                          {
+                            const uint32_t x = b_x * m_side[0] + c_x;
+                            const uint32_t y = b_y * m_side[1] + c_y;
+                            const uint32_t z = b_z * m_side[2] + c_z;
+
+                            if(x < m_extent[0] && y < m_extent[1] && z < m_extent[2])
+                              {
+                                function(i, x, y, z);
+                              }
+                          }
+                      }
+                  }
+              }
+          }
+      }
+  }
+
+private:
+  uint32_t m_extent[3] = { 0, 0, 0 }; ///< Number of cells along each axis.
+  uint32_t m_side[3]   = { 0, 0, 0 }; ///< Side of a brick along each axis.
+  uint32_t m_bricks[3] = { 0, 0, 0 }; ///< Number of bricks along each axis.
+};
+
+/**
+ * @brief Matrix of cells, the extent type limits its dimensions.
+ *
+ * @tparam Extent The type of a dimension and a coordinate, uint8_t, uint16_t or uint32_t.
+ * @tparam Layout The memory layout, RowMajorLayout, MortonLayout or BrickLayout.
+ */
+template <typename Extent, typename Layout = RowMajorLayout>
+class BasicMatrix
+{
+public:
+  using Shape = BasicShape<Extent>;
+
 public:
   /** =============================== CONSTRUCTORS ================================= */
 
@@ -26,27 +534,27 @@ public:
    *
    * @param shape Shape structure containing the dimensions of the matrix
    */
-  Matrix(const Shape& shape = {});
+  BasicMatrix(const Shape& shape = {});
 
   /**
    * @brief  Destroys the Matrix object.
    *
    */
-  ~Matrix();
+  ~BasicMatrix();
 
   /**
    * @brief Copy constructor.
    *
    * @param matrix The matrix to be copied.
    */
-  Matrix(const Matrix& matrix);
+  BasicMatrix(const BasicMatrix& matrix);
 
   /**
    * @brief Move constructor.
    *
    * @param matrix The matrix to be moved.
    */
-  Matrix(Matrix&& matrix);
+  BasicMatrix(BasicMatrix&& matrix);
 
 public:
   /** =============================== OPERATORS ==================================== */
@@ -55,19 +563,19 @@ public:
    * @brief Copy assignment operator.
    *
    * @param matrix The matrix to copy from.
-   * @return Matrix&
+   * @return BasicMatrix&
    */
-  Matrix&
-  operator=(const Matrix& matrix);
+  BasicMatrix&
+  operator=(const BasicMatrix& matrix);
 
   /**
    * @brief Move assignment operator.
    *
    * @param matrix The matrix to be moved.
-   * @return Matrix&
+   * @return BasicMatrix&
    */
-  Matrix&
-  operator=(Matrix&& matrix);
+  BasicMatrix&
+  operator=(BasicMatrix&& matrix);
 
 public:
   /** =============================== PUBLIC METHODS =============================== */
@@ -105,7 +613,7 @@ public:
    * @return const uint8_t&
    */
   const uint8_t&
-  get_at(const uint8_t x, const uint8_t y, const uint8_t z) const;
+  get_at(const Extent x, const Extent y, const Extent z) const;
 
   /**
    * @brief Sets the value at the given (x, y, z) coordinates.
@@ -116,7 +624,86 @@ public:
    * @param z Z-coordinate (depth).
    */
   void
-  set_at(const uint8_t value, const uint8_t x, const uint8_t y, const uint8_t z);
+  set_at(const uint8_t value, const Extent x, const Extent y, const Extent z);
+
+  /**
+   * @brief Returns a view of the matrix.
+   *
+   * @tparam Access The access policy of the view.
+   * @return BasicView<Extent, uint8_t, Access>
+   */
+  template <typename Access = DefaultAccess>
+  BasicView<Extent, uint8_t, Access>
+  view()
+    requires std::is_same_v<Layout, RowMajorLayout>
+  {
+    return BasicView<Extent, uint8_t, Access>(m_data, m_shape);
+  }
+
+  /**
+   * @brief Returns a read-only view of the matrix.
+   *
+   * @tparam Access The access policy of the view.
+   * @return BasicView<Extent, const uint8_t, Access>
+   */
+  template <typename Access = DefaultAccess>
+  BasicView<Extent, const uint8_t, Access>
+  view() const
+    requires std::is_same_v<Layout, RowMajorLayout>
+  {
+    return BasicView<Extent, const uint8_t, Access>(m_data, m_shape);
+  }
+
+  /**
+   * @brief Calls the function with the coordinates and the value of every cell, in memory order.
+   *
+   * @tparam Function Callable taking x, y, z and a reference to the value.
+   * @param function The function to call.
+   */
+  template <typename Function>
+  void
+  for_each(Function&& function)
+  {
+    m_layout.for_each([&](const std::size_t i, const uint32_t x, const uint32_t y, const uint32_t z) { function(Extent(x), Extent(y), Extent(z), m_data[i]); });
+  }
+
+  /**
+   * @brief Calls the function with the coordinates and the value of every cell, in memory order.
+   *
+   * @tparam Function Callable taking x, y, z and a const reference to the value.
+   * @param function The function to call.
+   */
+  template <typename Function>
+  void
+  for_each(Function&& function) const
+  {
+    m_layout.for_each([&](const std::size_t i, const uint32_t x, const uint32_t y, const uint32_t z) { function(Extent(x), Extent(y), Extent(z), static_cast<const uint8_t&>(m_data[i])); });
+  }
+
+  /**
+   * @brief Converts the matrix to the row-major layout of the saved arrays.
+   *
+   * @return BasicMatrix<Extent>
+   */
+  BasicMatrix<Extent>
+  to_row_major() const;
+
+  /**
+   * @brief Constructs a matrix of this layout from the row-major one.
+   *
+   * @param matrix The row-major matrix.
+   * @return BasicMatrix
+   */
+  static BasicMatrix
+  from_row_major(const BasicMatrix<Extent>& matrix);
+
+  /**
+   * @brief Sets every element of the matrix to the value.
+   *
+   * @param value The value to set.
+   */
+  void
+  fill(const uint8_t value) noexcept(true);
 
   /**
    * @brief Clears the matrix data.
@@ -137,10 +724,22 @@ private:
   allocate();
 
 private:
-  Shape    m_shape; ///< Holds the dimensions of the matrix.
-  uint8_t* m_data;  ///< Pointer to the dynamically allocated matrix data.
+  Shape    m_shape;  ///< Holds the dimensions of the matrix.
+  Layout   m_layout; ///< Maps the coordinates to the memory.
+  uint8_t* m_data;   ///< Pointer to the dynamically allocated matrix data.
 };
 
+using Shape    = BasicShape<uint8_t>;
+using Shape16  = BasicShape<uint16_t>;
+using Shape32  = BasicShape<uint32_t>;
+
+using Matrix   = BasicMatrix<uint8_t>;
+using Matrix16 = BasicMatrix<uint16_t>;
+using Matrix32 = BasicMatrix<uint32_t>;
+
+using MortonMatrix = BasicMatrix<uint8_t, MortonLayout>;
+using BrickMatrix  = BasicMatrix<uint8_t, BrickLayout<>>;
+
 } // namespace matrix
 
 #endif
\ No newline at end of file
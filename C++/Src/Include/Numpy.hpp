@@ -1,11 +1,19 @@
 #ifndef __NUMPY_HPP__
 #define __NUMPY_HPP__
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "Include/Matrix.hpp"
+
 namespace numpy
 {
 
@@ -13,20 +21,22 @@ namespace numpy
  * @brief Saves a matrix as numpy array.
  *
  * @tparam Tp The data type.
+ * @tparam Sp The shape's dimension type.
  * @param file_path The save path.
  * @param data The matrix's data to save.
  * @param shape The matrix's shape.
  */
-template <typename Tp>
+template <typename Tp, typename Sp = std::size_t>
 void
-save_as(const std::filesystem::path& file_path, const char* data, const std::vector<uint8_t>& shape)
+save_as(const std::filesystem::path& file_path, const char* data, const std::vector<Sp>& shape)
 {
   if(!std::filesystem::exists(file_path.parent_path()))
     {
       throw std::invalid_argument("Numpy Error: Can't locate parent folder by given path: \"" + file_path.string() + "\".");
     }
 
-  if(data == nullptr)
+  /** Empty arrays, e.g. edges of a graph without edges, may come without data */
+  if(data == nullptr && std::find(shape.begin(), shape.end(), Sp(0)) == shape.end())
     {
       throw std::invalid_argument("Numpy Error: data nullptr exception.");
     }
@@ -79,11 +89,17 @@ save_as(const std::filesystem::path& file_path, const char* data, const std::vec
         }
     }
 
+  /** One dimensional shape must still be a tuple */
+  if(shape.size() == 1)
+    {
+      header += ",";
+    }
+
   header += "), }";
 
   std::size_t       header_length       = header.size();
-  const std::size_t total_header_length = 8 + 2 + header_length;                  /** 8 bytes for magic + 2 byte version + header_len_field */
-  const std::size_t padding             = (16 - (total_header_length % 16)) % 16; /** Align to 16 bytes */
+  const std::size_t total_header_length = 8 + 2 + header_length + 1;              /** 8 bytes for magic + 2 byte version + header_len_field, and the newline */
+  const std::size_t padding             = (16 - (total_header_length % 16)) % 16; /** Align the payload to 16 bytes */
 
   /** Update header length to include padding */
   header_length += padding + 1;
@@ -116,6 +132,179 @@ save_as(const std::filesystem::path& file_path, const char* data, const std::vec
   out_file.close();
 }
 
+/**
+ * @brief Read-only numpy array mapped into memory. The header is validated once on
+ * opening, the payload is never copied and is paged in by the system on access.
+ *
+ */
+class MappedArray
+{
+public:
+  /** =============================== CONSTRUCTORS ================================= */
+
+  /**
+   * @brief Maps the numpy array file.
+   *
+   * @param file_path The path of the file.
+   */
+  explicit MappedArray(const std::filesystem::path& file_path);
+
+  /**
+   * @brief Unmaps the file.
+   *
+   */
+  ~MappedArray();
+
+  MappedArray(const MappedArray&) = delete;
+
+  /**
+   * @brief Move constructor.
+   *
+   * @param array The array to be moved.
+   */
+  MappedArray(MappedArray&& array) noexcept;
+
+public:
+  /** =============================== OPERATORS ==================================== */
+
+  MappedArray&
+  operator=(const MappedArray&) = delete;
+
+  /**
+   * @brief Move assignment operator.
+   *
+   * @param array The array to be moved.
+   * @return MappedArray&
+   */
+  MappedArray&
+  operator=(MappedArray&& array) noexcept;
+
+public:
+  /** =============================== PUBLIC METHODS =============================== */
+
+  /**
+   * @brief Returns the shape of the array.
+   *
+   * @return const std::vector<std::size_t>&
+   */
+  const std::vector<std::size_t>&
+  shape() const;
+
+  /**
+   * @brief Returns the number of elements of the array.
+   *
+   * @return std::size_t
+   */
+  std::size_t
+  size() const;
+
+  /**
+   * @brief Returns the kind of the elements: 'u', 'i' or 'f'.
+   *
+   * @return char
+   */
+  char
+  kind() const;
+
+  /**
+   * @brief Returns the size of an element in bytes.
+   *
+   * @return std::size_t
+   */
+  std::size_t
+  item_size() const;
+
+  /**
+   * @brief Returns the first byte of the payload.
+   *
+   * @return const char*
+   */
+  const char*
+  data() const;
+
+  /**
+   * @brief Returns the payload as elements of the type, it must be the type of the array.
+   *
+   * @tparam Tp The data type.
+   * @return std::span<const Tp>
+   */
+  template <typename Tp>
+  std::span<const Tp>
+  as() const
+  {
+    if(kind() != type_kind<Tp>() || item_size() != sizeof(Tp))
+      {
+        throw std::invalid_argument("Numpy Error: The array doesn't hold elements of the requested type.");
+      }
+
+    if(reinterpret_cast<std::uintptr_t>(data()) % alignof(Tp) != 0)
+      {
+        throw std::runtime_error("Numpy Error: The payload is not aligned to its elements.");
+      }
+
+    return std::span<const Tp>(reinterpret_cast<const Tp*>(data()), size());
+  }
+
+  /**
+   * @brief Returns a read-only view of a matrix saved as (depth, size, size) cells.
+   *
+   * @tparam Extent The type of a coordinate.
+   * @tparam Access The access policy of the view.
+   * @return matrix::BasicView<Extent, const uint8_t, Access>
+   */
+  template <typename Extent = uint8_t, typename Access = matrix::DefaultAccess>
+  matrix::BasicView<Extent, const uint8_t, Access>
+  view() const
+  {
+    if(shape().size() != 3)
+      {
+        throw std::invalid_argument("Numpy Error: A matrix must have three dimensions.");
+      }
+
+    if(std::any_of(shape().begin(), shape().end(), [](const std::size_t dimension) { return dimension > std::numeric_limits<Extent>::max(); }))
+      {
+        throw std::invalid_argument("Numpy Error: The matrix doesn't fit the extent type.");
+      }
+
+    const std::span<const uint8_t> cells = as<uint8_t>();
+
+    return matrix::BasicView<Extent, const uint8_t, Access>(cells.data(), { Extent(shape()[2]), Extent(shape()[1]), Extent(shape()[0]) });
+  }
+
+private:
+  /** =============================== PRIVATE METHODS ============================== */
+
+  template <typename Tp>
+  static constexpr char
+  type_kind()
+  {
+    return std::is_floating_point_v<Tp> ? 'f' : (std::is_signed_v<Tp> ? 'i' : 'u');
+  }
+
+  /**
+   * @brief Parses and validates the header, the payload must fit the mapped file.
+   *
+   */
+  void
+  parse_header();
+
+  /**
+   * @brief Unmaps the file if it is mapped.
+   *
+   */
+  void
+  release() noexcept;
+
+private:
+  const char*              m_mapping   = nullptr; ///< The mapped file.
+  std::size_t              m_length    = 0;       ///< Length of the mapped file.
+  const char*              m_data      = nullptr; ///< The first byte of the payload.
+  std::vector<std::size_t> m_shape;               ///< Shape of the array.
+  std::size_t              m_size      = 0;       ///< Number of elements.
+  char                     m_kind      = 0;       ///< Kind of the elements.
+  std::size_t              m_item_size = 0;       ///< Size of an element in bytes.
+};
+
 } // namespace numpy
 
 #endif
\ No newline at end of file
@@ -1,6 +1,12 @@
 #ifndef __TRANSFORM_HPP__
 #define __TRANSFORM_HPP__
 
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Include/BitPlaneMatrix.hpp"
 #include "Include/Graph.hpp"
 #include "Include/Matrix.hpp"
 #include "Include/Types.hpp"
@@ -8,25 +14,205 @@
 namespace transform
 {
 
+/**
+ * @brief Graph in compressed sparse row form, ready for graph neural networks. Node ids are 0-based.
+ *
+ * @tparam Extent The type of a coordinate.
+ */
+template <typename Extent>
+struct CsrGraph
+{
+  std::vector<Extent>   m_features; ///< x, y, z and terminal flag of every node, row-major.
+  std::vector<uint32_t> m_indptr;   ///< Offsets of the edges of every node, one more than the number of nodes.
+  std::vector<uint32_t> m_indices;  ///< Destination node of every edge.
+  std::vector<uint32_t> m_weights;  ///< Weight of every edge.
+  std::vector<uint8_t>  m_labels;   ///< 1 if the edge belongs to the solution, 0 otherwise.
+};
+
+/**
+ * @brief Solution tree as straight segments between the points where it branches, ends or
+ * bends. Branching points that are not terminals are the Steiner points of the tree.
+ *
+ * @tparam Extent The type of a coordinate.
+ */
+template <typename Extent>
+struct SparseTree
+{
+  std::vector<Extent>   m_points;   ///< x, y and z of every point, row-major.
+  std::vector<uint32_t> m_segments; ///< Pairs of 0-based points joined by an axis-aligned segment.
+};
+
+/**
+ * @brief Converts 1D index to 3D index.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param index The 1D index.
+ * @param size The size of a matrix.
+ * @return matrix::Coordinates<Extent>
+ */
+template <typename Extent = uint8_t>
+matrix::Coordinates<Extent>
+index_to_coordinates(uint64_t index, std::type_identity_t<Extent> size);
+
 /**
  * @brief Constructs a graph from a given matrix.
  *
+ * @tparam Extent The type of a coordinate.
  * @param matrix The matrix to use to construct the graph.
- * @return std::pair<graph::Graph, std::vector<std::tuple<uint8_t, uint8_t, uint8_t>>>
+ * @param inital_state The node to start from.
+ * @param layer_directions The routing directions of layers, repeated over the depth. Empty for all directions.
+ * @return std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>>
+ */
+template <typename Extent = uint8_t>
+std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>>
+matrix_to_graph(const matrix::BasicMatrix<Extent>& matrix, const matrix::Coordinates<Extent>& inital_state, const std::vector<uint8_t>& layer_directions = {});
+
+/**
+ * @brief Rasterizes the trace terrain of the given terminals into a matrix.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param shape The shape of the matrix.
+ * @param terminals The terminals coordinates.
+ * @return matrix::BasicMatrix<Extent>
+ */
+template <typename Extent = uint8_t>
+matrix::BasicMatrix<Extent>
+terminals_to_matrix(const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals);
+
+/**
+ * @brief Rasterizes the trace terrain of the given terminals into the given matrix,
+ * overwriting its content.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param matrix The matrix to write to.
+ * @param terminals The terminals coordinates.
  */
-std::pair<graph::Graph, std::vector<std::tuple<uint8_t, uint8_t, uint8_t>>>
-matrix_to_graph(const matrix::Matrix& matrix, const std::tuple<uint8_t, uint8_t, uint8_t>& inital_state);
+template <typename Extent = uint8_t>
+void
+terminals_to_matrix(matrix::BasicMatrix<Extent>& matrix, const std::vector<matrix::Coordinates<Extent>>& terminals);
+
+/**
+ * @brief Rasterizes the trace terrain of the given terminals into bit-planes of cell classes.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param shape The shape of the matrix.
+ * @param terminals The terminals coordinates.
+ * @return matrix::BasicBitPlaneMatrix<Extent>
+ */
+template <typename Extent = uint8_t>
+matrix::BasicBitPlaneMatrix<Extent>
+terminals_to_bit_planes(const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals);
+
+/**
+ * @brief Computes the extra input channels of the terminals in the memory order of the
+ * matrix. The first channel holds the Manhattan distance of every cell to the nearest
+ * terminal, saturated at UINT16_MAX. The second one is 1 inside the bounding box of the
+ * terminals and 0 outside.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param features The channels to write to, resized to two matrices.
+ * @param shape The shape of the matrix.
+ * @param terminals The terminals coordinates.
+ */
+template <typename Extent = uint8_t>
+void
+terminals_to_features(std::vector<uint16_t>& features, const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals);
+
+/**
+ * @brief Constructs the graph of the trace terrain straight from the terminals. The result
+ * is the same as of matrix_to_graph over terminals_to_matrix started from the first terminal.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param shape The shape of the terrain.
+ * @param terminals The terminals coordinates.
+ * @param layer_directions The routing directions of layers, repeated over the depth. Empty for all directions.
+ * @return std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>>
+ */
+template <typename Extent = uint8_t>
+std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>>
+terminals_to_graph(const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals, const std::vector<uint8_t>& layer_directions = {});
+
+/**
+ * @brief Same as terminals_to_graph, writes into the given graph and nodes so that their
+ * storage can be reused between calls. The layout, the compression, the ray masks and the
+ * maps of the call are allocated from the given memory, a pool keeps it for the next call.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param graph The graph to write to, cleared first.
+ * @param nodes The coordinates of the nodes to write to, cleared first.
+ * @param shape The shape of the terrain.
+ * @param terminals The terminals coordinates.
+ * @param layer_directions The routing directions of layers, repeated over the depth. Empty for all directions.
+ * @param memory The memory of the temporary containers.
+ */
+template <typename Extent = uint8_t>
+void
+terminals_to_graph(graph::Graph& graph, std::vector<matrix::Coordinates<Extent>>& nodes, const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals, const std::vector<uint8_t>& layer_directions = {}, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+/**
+ * @brief Rasterizes a tree into the given matrix, overwriting its content. Segments are
+ * written as whole spans.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param matrix The matrix to write to.
+ * @param mst The edges of the tree.
+ * @param nodes The coordinates of the nodes.
+ */
+template <typename Extent = uint8_t>
+void
+mst_to_matrix(matrix::BasicMatrix<Extent>& matrix, const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<matrix::Coordinates<Extent>>& nodes);
 
 /**
  * @brief Constructs a matrix from a given graph.
  *
+ * @tparam Extent
  * @param shape
  * @param mst
  * @param nodes
- * @return matrix::Matrix
+ * @return matrix::BasicMatrix<Extent>
+ */
+template <typename Extent = uint8_t>
+matrix::BasicMatrix<Extent>
+mst_to_matrix(const matrix::BasicShape<Extent> shape, const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<matrix::Coordinates<Extent>>& nodes);
+
+/**
+ * @brief Converts a tree to its sparse form. Runs of collinear edges are merged into a
+ * single segment.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param mst The edges of the tree.
+ * @param nodes The coordinates of the nodes.
+ * @return SparseTree<Extent>
+ */
+template <typename Extent = uint8_t>
+SparseTree<Extent>
+mst_to_sparse(const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<matrix::Coordinates<Extent>>& nodes);
+
+/**
+ * @brief Rasterizes a sparse tree into the given matrix, overwriting its content. The
+ * result is the same as of mst_to_matrix over the tree it was made from.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param matrix The matrix to write to.
+ * @param tree The sparse tree.
+ */
+template <typename Extent = uint8_t>
+void
+sparse_to_matrix(matrix::BasicMatrix<Extent>& matrix, const SparseTree<Extent>& tree);
+
+/**
+ * @brief Exports a graph and its solution in compressed sparse row form. Every undirected
+ * edge is listed from both of its ends.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param graph The graph.
+ * @param nodes The coordinates of the nodes.
+ * @param mst The edges of the solution.
+ * @return CsrGraph<Extent>
  */
-matrix::Matrix
-mst_to_matrix(const matrix::Shape shape, const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<std::tuple<uint8_t, uint8_t, uint8_t>>& nodes);
+template <typename Extent = uint8_t>
+CsrGraph<Extent>
+graph_to_csr(const graph::Graph& graph, const std::vector<matrix::Coordinates<Extent>>& nodes, const std::vector<std::pair<uint32_t, uint32_t>>& mst);
 
 } // namespace algo
 
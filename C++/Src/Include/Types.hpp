@@ -12,6 +12,11 @@ constexpr uint8_t TERMINAL_CELL         = 4;
 constexpr uint8_t INTERSECTION_CELL     = 3;
 constexpr uint8_t INTERSECTION_VIA_CELL = 2;
 
+/** Routing directions of a layer */
+constexpr uint8_t HORIZONTAL_LAYER      = 1;
+constexpr uint8_t VERTICAL_LAYER        = 2;
+constexpr uint8_t ANY_DIRECTION_LAYER   = HORIZONTAL_LAYER | VERTICAL_LAYER;
+
 } // namespace types
 
 #endif
\ No newline at end of file
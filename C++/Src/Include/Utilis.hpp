@@ -1,9 +1,17 @@
 #ifndef __UTILS_HPP__
 #define __UTILS_HPP__
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 namespace utils
 {
@@ -27,6 +35,100 @@ private:
   std::chrono::_V2::steady_clock::time_point m_start_time;
 };
 
+/**
+ * @brief Returns the number of CPUs the process may use: the hardware threads, bounded by
+ * the affinity mask and the cgroup CPU quota.
+ *
+ * @return std::size_t At least 1.
+ */
+std::size_t
+available_cpus();
+
+/**
+ * @brief Persistent pool of workers with a deque of tasks each. A worker takes tasks
+ * from the front of its own deque and steals from the back of the others when it runs
+ * dry, so that the workers stay busy until the last task.
+ *
+ */
+class TaskPool
+{
+public:
+  /** The task gets the index of the worker running it */
+  using Task = std::function<void(std::size_t)>;
+
+  /** The job gets its index and the index of the worker running it */
+  using Job  = std::function<void(std::size_t, std::size_t)>;
+
+  explicit TaskPool(const std::size_t number_of_workers);
+
+  ~TaskPool();
+
+  TaskPool(const TaskPool&) = delete;
+
+  TaskPool&
+  operator=(const TaskPool&) = delete;
+
+  /**
+   * @brief Returns the number of workers.
+   *
+   * @return std::size_t
+   */
+  std::size_t
+  size() const;
+
+  /**
+   * @brief Queues a task, the deques are filled in turn.
+   *
+   * @param task The task.
+   */
+  void
+  submit(Task task);
+
+  /**
+   * @brief Waits until all queued tasks are done. Rethrows the first exception thrown
+   * by a task.
+   *
+   */
+  void
+  wait();
+
+  /**
+   * @brief Runs jobs from within a task and returns once all of them are done. The calling
+   * worker works through the jobs and idle workers join in, so a task never waits on the
+   * rest of the pool. Rethrows the first exception thrown by a job.
+   *
+   * @param worker The worker running the calling task.
+   * @param count The number of jobs.
+   * @param job The job.
+   */
+  void
+  for_each(const std::size_t worker, const std::size_t count, const Job& job);
+
+private:
+  struct Queue
+  {
+    std::mutex       m_mutex;
+    std::deque<Task> m_tasks;
+  };
+
+  void
+  work(const std::size_t worker);
+
+  bool
+  take(const std::size_t worker, Task& task);
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread>            m_threads;
+  std::mutex                          m_mutex;
+  std::condition_variable             m_queued_condition;
+  std::condition_variable             m_done_condition;
+  std::size_t                         m_queued  = 0;
+  std::size_t                         m_pending = 0;
+  std::atomic<std::size_t>            m_next    = 0;
+  bool                                m_stop    = false;
+  std::exception_ptr                  m_error;
+};
+
 } // namespace utils
 
 #endif
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include <algorithm>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory_resource>
 #include <numeric>
 #include <queue>
 #include <set>
-#include <thread>
 #include <unordered_map>
 
 #include "Include/Algorithms.hpp"
@@ -29,17 +31,32 @@ namespace details
 class UnionFind
 {
 private:
-  std::vector<uint32_t> parent;
-  std::vector<uint32_t> rank;
+  std::vector<uint32_t>  own_parent;
+  std::vector<uint32_t>  own_rank;
+  std::vector<uint32_t>& parent;
+  std::vector<uint32_t>& rank;
 
 public:
   UnionFind(std::size_t n)
+      : UnionFind(own_parent, own_rank, n)
+  {
+  }
+
+  /** Runs on the given storage, which keeps its capacity for the next union-find */
+  UnionFind(std::vector<uint32_t>& parent_storage, std::vector<uint32_t>& rank_storage, std::size_t n)
+      : parent(parent_storage), rank(rank_storage)
   {
     parent.resize(n);
-    rank.resize(n, 0);
+    rank.assign(n, 0);
     std::iota(parent.begin(), parent.end(), 0);
   }
 
+  UnionFind(const UnionFind&) = delete;
+
+  UnionFind&
+  operator=(const UnionFind&)
+      = delete;
+
   uint32_t
   find(uint32_t u)
   {
@@ -122,33 +139,49 @@ struct PathInfo
   std::vector<graph::Edge> m_path;
 };
 
-std::unordered_map<graph::Edge, std::vector<uint32_t>>
-all_paths_dijkstra(const std::unordered_set<uint32_t>& terminals, const std::vector<std::vector<graph::Edge>>& adj, const std::size_t paths_count)
+std::pmr::unordered_map<graph::Edge, std::pmr::vector<uint32_t>>
+all_paths_dijkstra(const std::vector<uint32_t>& terminals_v, const std::vector<std::vector<graph::Edge>>& adj, const std::size_t paths_count, Workspace& workspace)
 {
-  const std::vector<uint32_t>                            terminals_v(terminals.begin(), terminals.end());
-  const std::size_t                                      num_vertices  = adj.size();
-  const std::size_t                                      num_terminals = terminals.size();
+  const std::size_t                                                num_vertices  = adj.size();
+  const std::size_t                                                num_terminals = terminals_v.size();
 
-  std::unordered_map<graph::Edge, std::vector<uint32_t>> merge_collection;
-  uint32_t                                               path_counter = 0;
+  std::pmr::unordered_map<graph::Edge, std::pmr::vector<uint32_t>> merge_collection(&workspace.m_memory);
+  uint32_t                                                         path_counter = 0;
 
   for(uint32_t i = 0; i < num_terminals; ++i)
     {
-      const uint32_t                     src = terminals_v[i];
+      const uint32_t src   = terminals_v[i];
+
+      auto&          dist  = workspace.m_dist;
+      auto&          prev  = workspace.m_prev;
+      auto&          queue = workspace.m_queue;
+
+      dist.assign(num_vertices, std::numeric_limits<uint32_t>::max());
+      prev.resize(std::max(prev.size(), num_vertices));
 
-      std::vector<uint32_t>              dist(num_vertices, std::numeric_limits<uint32_t>::max());
-      std::vector<std::vector<uint32_t>> prev(num_vertices);
+      for(std::size_t v = 0; v < num_vertices; ++v)
+        {
+          prev[v].clear();
+        }
 
       dist[src - 1] = 0;
 
-      std::priority_queue<graph::Edge, std::vector<graph::Edge>, std::greater<graph::Edge>> queue;
-      queue.emplace(0, src);
+      /** Binary heap on the reused storage, the same order as of std::priority_queue */
+      auto push     = [&](const uint32_t weight, const uint32_t node) {
+        queue.push_back(graph::Edge{ weight, node, 0 });
+        std::push_heap(queue.begin(), queue.end(), std::greater<graph::Edge>());
+      };
+
+      queue.clear();
+      push(0, src);
 
       while(!queue.empty())
         {
-          const uint32_t u      = queue.top().m_source;
-          const uint32_t dist_u = queue.top().m_destination;
-          queue.pop();
+          const uint32_t u      = queue.front().m_source;
+          const uint32_t dist_u = queue.front().m_destination;
+
+          std::pop_heap(queue.begin(), queue.end(), std::greater<graph::Edge>());
+          queue.pop_back();
 
           if(dist_u > dist[u - 1])
             {
@@ -165,7 +198,7 @@ all_paths_dijkstra(const std::unordered_set<uint32_t>& terminals, const std::vec
                   dist[v - 1] = alt;
                   prev[v - 1].clear();
                   prev[v - 1].push_back(u);
-                  queue.emplace(alt, v);
+                  push(alt, v);
                 }
               else if(alt == dist[v - 1])
                 {
@@ -183,8 +216,8 @@ all_paths_dijkstra(const std::unordered_set<uint32_t>& terminals, const std::vec
               continue;
             }
 
-          std::queue<std::vector<uint32_t>> prev_queue;
-          prev_queue.push({ dst });
+          std::queue<std::pmr::vector<uint32_t>, std::pmr::deque<std::pmr::vector<uint32_t>>> prev_queue(&workspace.m_memory);
+          prev_queue.emplace(std::initializer_list<uint32_t>{ dst });
 
           ++path_counter;
 
@@ -239,7 +272,7 @@ all_paths_dijkstra(const std::unordered_set<uint32_t>& terminals, const std::vec
                 {
                   for(const uint32_t prev_node : prev[current_node - 1])
                     {
-                      std::vector<uint32_t> new_path = current_path;
+                      std::pmr::vector<uint32_t> new_path(current_path, &workspace.m_memory);
                       new_path.push_back(prev_node);
                       prev_queue.push(std::move(new_path));
                     }
@@ -251,10 +284,86 @@ all_paths_dijkstra(const std::unordered_set<uint32_t>& terminals, const std::vec
   return merge_collection;
 }
 
+/**
+ * @brief Removes non-terminal leaves from the tree until there are none.
+ *
+ * @param mst The edges of the tree.
+ * @param mst_nodes The degrees of the tree nodes.
+ * @param terminals The terminals.
+ */
+void
+prune_leaves(std::vector<graph::Edge>& mst, std::pmr::unordered_map<uint32_t, uint32_t>& mst_nodes, const std::unordered_set<uint32_t>& terminals)
+{
+  while(true)
+    {
+      bool is_found = false;
+
+      for(std::size_t i = 0, end = mst.size(); i < end; ++i)
+        {
+          const auto& edge = mst[i];
+
+          if(mst_nodes[edge.m_source] == 1 && terminals.count(edge.m_source) == 0)
+            {
+              mst_nodes[edge.m_source] -= 1;
+              mst_nodes[edge.m_destination] -= 1;
+
+              if(mst_nodes[edge.m_destination] == 0)
+                {
+                  mst_nodes.erase(edge.m_destination);
+                }
+
+              if(mst_nodes[edge.m_source] == 0)
+                {
+                  mst_nodes.erase(edge.m_source);
+                }
+
+              mst.erase(mst.begin() + i);
+              is_found = true;
+              --i;
+              --end;
+            }
+          else if(mst_nodes[edge.m_destination] == 1 && terminals.count(edge.m_destination) == 0)
+            {
+              mst_nodes[edge.m_source] -= 1;
+              mst_nodes[edge.m_destination] -= 1;
+
+              if(mst_nodes[edge.m_source] == 0)
+                {
+                  mst_nodes.erase(edge.m_source);
+                }
+
+              if(mst_nodes[edge.m_destination] == 0)
+                {
+                  mst_nodes.erase(edge.m_destination);
+                }
+
+              mst.erase(mst.begin() + i);
+              is_found = true;
+              --i;
+              --end;
+            }
+        }
+
+      if(!is_found)
+        {
+          break;
+        }
+    }
+}
+
 } // namespace details
 
 std::vector<std::pair<uint32_t, uint32_t>>
 dijkstra_kruskal_greedy(const graph::Graph& graph)
+{
+  Workspace workspace;
+  dijkstra_kruskal_greedy(graph, workspace);
+
+  return std::move(workspace.m_tree);
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>>&
+dijkstra_kruskal_greedy(const graph::Graph& graph, Workspace& workspace)
 {
   const auto& adj         = graph.get_adj();
   const auto& terminals   = graph.get_terminals();
@@ -266,10 +375,13 @@ dijkstra_kruskal_greedy(const graph::Graph& graph)
       paths_count += i;
     }
 
-  const auto                         merge_collection = details::all_paths_dijkstra(terminals, adj, paths_count);
+  std::vector<uint32_t>& terminals_v = workspace.m_terminals;
+  terminals_v.assign(terminals.begin(), terminals.end());
+
+  /** The maps, sets and paths of a call are allocated from the workspace's pool, so that their memory is recycled */
+  const auto                                   merge_collection = details::all_paths_dijkstra(terminals_v, adj, paths_count, workspace);
 
-  std::vector<std::set<graph::Edge>> blocks;
-  blocks.resize(paths_count, {});
+  std::pmr::vector<std::pmr::set<graph::Edge>> blocks(paths_count, &workspace.m_memory);
 
   for(const auto& [key, value] : merge_collection)
     {
@@ -286,11 +398,11 @@ dijkstra_kruskal_greedy(const graph::Graph& graph)
       blocks[merge - 1].insert(key);
     }
 
-  const std::vector<uint32_t>            terminals_v(terminals.begin(), terminals.end());
+  details::UnionFind                          uf(workspace.m_parent, workspace.m_rank, adj.size() + 1);
+  std::vector<graph::Edge>&                   mst = workspace.m_mst;
+  std::pmr::unordered_map<uint32_t, uint32_t> mst_nodes(&workspace.m_memory);
 
-  details::UnionFind                     uf(adj.size());
-  std::vector<graph::Edge>               mst;
-  std::unordered_map<uint32_t, uint32_t> mst_nodes;
+  mst.clear();
 
   for(int32_t i = blocks.size() - 1; i >= 0; --i)
     {
@@ -305,7 +417,7 @@ dijkstra_kruskal_greedy(const graph::Graph& graph)
 
               mst.push_back(edge);
 
-              if(done = uf.connected(terminals_v))
+              if((done = uf.connected(terminals_v)))
                 {
                   break;
                 }
@@ -318,62 +430,236 @@ dijkstra_kruskal_greedy(const graph::Graph& graph)
         }
     }
 
-  while(true)
+  details::prune_leaves(mst, mst_nodes, terminals);
+
+  std::vector<std::pair<uint32_t, uint32_t>>& final_mst = workspace.m_tree;
+
+  final_mst.clear();
+
+  for(const auto& edge : mst)
     {
-      bool is_found = false;
+      final_mst.emplace_back(edge.m_source, edge.m_destination);
+    }
 
-      for(std::size_t i = 0, end = mst.size(); i < end; ++i)
+  return final_mst;
+}
+
+bool
+spans_terminals(const graph::Graph& graph, const std::vector<std::pair<uint32_t, uint32_t>>& tree, const std::size_t number_of_terminals)
+{
+  const auto& terminals = graph.get_terminals();
+
+  if(terminals.size() != number_of_terminals)
+    {
+      return false;
+    }
+
+  details::UnionFind uf(graph.get_adj().size() + 1);
+
+  for(const auto& [source, destination] : tree)
+    {
+      uf.union_sets(source, destination);
+    }
+
+  const uint32_t root = terminals.empty() ? 0 : uf.find(*terminals.begin());
+
+  return std::all_of(terminals.begin(), terminals.end(), [&uf, root](const uint32_t terminal) { return uf.find(terminal) == root; });
+}
+
+template <typename Extent>
+std::vector<std::pair<uint32_t, uint32_t>>
+tiled_dijkstra_kruskal_greedy(const graph::Graph& graph, const std::vector<matrix::Coordinates<Extent>>& nodes, const uint32_t tile_size, const uint32_t overlap, utils::TaskPool& pool, const std::size_t worker, std::vector<Workspace>& workspaces)
+{
+  const auto&                                      adj       = graph.get_adj();
+  const auto&                                      terminals = graph.get_terminals();
+
+  /** Group terminals by the tile they are in */
+  std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>> tiles;
+
+  for(const uint32_t terminal : terminals)
+    {
+      const auto [x, y, z] = nodes[terminal - 1];
+      tiles[{ x / tile_size, y / tile_size }].push_back(terminal);
+    }
+
+  std::vector<std::pair<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>>> tasks;
+
+  for(auto& [tile, tile_terminals] : tiles)
+    {
+      if(tile_terminals.size() > 1)
         {
-          const auto& edge = mst[i];
+          tasks.emplace_back(tile, std::move(tile_terminals));
+        }
+    }
 
-          if(mst_nodes[edge.m_source] == 1 && terminals.count(edge.m_source) == 0)
+  /** Solve every tile on the subgraph of the nodes within the tile and its overlap */
+  std::vector<std::vector<graph::Edge>> tile_trees(tasks.size());
+
+  pool.for_each(worker, tasks.size(), [&](const std::size_t t, const std::size_t tile_worker) {
+    Workspace& workspace = workspaces[tile_worker];
+
+    const auto& [tile, tile_terminals] = tasks[t];
+
+    const int64_t         min_x        = int64_t(tile.first) * tile_size - overlap;
+    const int64_t         max_x        = int64_t(tile.first + 1) * tile_size + overlap;
+    const int64_t         min_y        = int64_t(tile.second) * tile_size - overlap;
+    const int64_t         max_y        = int64_t(tile.second + 1) * tile_size + overlap;
+
+    std::vector<uint32_t> local(nodes.size(), 0);
+    std::vector<uint32_t> global;
+    graph::Graph          tile_graph;
+
+    for(uint32_t i = 0, end = nodes.size(); i < end; ++i)
+      {
+        const auto [x, y, z] = nodes[i];
+
+        if(int64_t(x) >= min_x && int64_t(x) < max_x && int64_t(y) >= min_y && int64_t(y) < max_y)
+          {
+            global.push_back(i + 1);
+            local[i] = global.size();
+            tile_graph.place_node();
+          }
+      }
+
+    for(const uint32_t node : global)
+      {
+        for(const auto& edge : adj[node - 1])
+          {
+            if(local[edge.m_destination - 1] != 0)
+              {
+                tile_graph.add_edge(edge.m_weight, local[node - 1] - 1, local[edge.m_destination - 1] - 1);
+              }
+          }
+      }
+
+    for(const uint32_t terminal : tile_terminals)
+      {
+        tile_graph.add_terminal(local[terminal - 1] - 1);
+      }
+
+    for(const auto& [source, destination] : dijkstra_kruskal_greedy(tile_graph, workspace))
+      {
+        const uint32_t g_source      = global[source - 1];
+        const uint32_t g_destination = global[destination - 1];
+
+        const auto&    connections   = adj[g_source - 1];
+        const auto     it            = std::find_if(connections.begin(), connections.end(), [g_destination](const graph::Edge& edge) { return edge.m_destination == g_destination; });
+
+        tile_trees[t].push_back({ it->m_weight, std::min(g_source, g_destination), std::max(g_source, g_destination) });
+      }
+  });
+
+  /** Stitch the subtrees: join the component of the first terminal with the closest other one until all are joined */
+  std::vector<graph::Edge> edges;
+  details::UnionFind       uf(nodes.size() + 1);
+
+  for(const auto& tree : tile_trees)
+    {
+      for(const auto& edge : tree)
+        {
+          uf.union_sets(edge.m_source, edge.m_destination);
+          edges.push_back(edge);
+        }
+    }
+
+  const std::vector<uint32_t> terminals_v(terminals.begin(), terminals.end());
+
+  while(!terminals_v.empty() && !uf.connected(terminals_v))
+    {
+      const uint32_t               root = uf.find(terminals_v.front());
+
+      std::unordered_set<uint32_t> targets;
+
+      for(const uint32_t terminal : terminals_v)
+        {
+          if(uf.find(terminal) != root)
             {
-              mst_nodes[edge.m_source] -= 1;
-              mst_nodes[edge.m_destination] -= 1;
+              targets.insert(uf.find(terminal));
+            }
+        }
 
-              if(mst_nodes[edge.m_destination] == 0)
-                {
-                  mst_nodes.erase(edge.m_destination);
-                }
+      std::vector<uint32_t>                                                                  dist(nodes.size() + 1, std::numeric_limits<uint32_t>::max());
+      std::vector<graph::Edge>                                                               prev(nodes.size() + 1);
+      std::priority_queue<graph::Edge, std::vector<graph::Edge>, std::greater<graph::Edge>> queue;
 
-              if(mst_nodes[edge.m_source] == 0)
-                {
-                  mst_nodes.erase(edge.m_source);
-                }
+      for(uint32_t node = 1, end = nodes.size(); node <= end; ++node)
+        {
+          if(uf.find(node) == root)
+            {
+              dist[node] = 0;
+              queue.emplace(0, node);
+            }
+        }
 
-              mst.erase(mst.begin() + i);
-              is_found = true;
-              --i;
-              --end;
+      uint32_t reached = 0;
+
+      while(!queue.empty())
+        {
+          const uint32_t u      = queue.top().m_source;
+          const uint32_t dist_u = queue.top().m_weight;
+          queue.pop();
+
+          if(dist_u > dist[u])
+            {
+              continue;
             }
-          else if(mst_nodes[edge.m_destination] == 1 && terminals.count(edge.m_destination) == 0)
+
+          if(targets.count(uf.find(u)) != 0)
             {
-              mst_nodes[edge.m_source] -= 1;
-              mst_nodes[edge.m_destination] -= 1;
+              reached = u;
+              break;
+            }
 
-              if(mst_nodes[edge.m_source] == 0)
-                {
-                  mst_nodes.erase(edge.m_source);
-                }
+          for(const auto& edge : adj[u - 1])
+            {
+              const uint32_t v   = edge.m_destination;
+              const uint32_t alt = dist_u + edge.m_weight;
 
-              if(mst_nodes[edge.m_destination] == 0)
+              if(alt < dist[v])
                 {
-                  mst_nodes.erase(edge.m_destination);
+                  dist[v] = alt;
+                  prev[v] = { edge.m_weight, std::min(u, v), std::max(u, v) };
+                  queue.emplace(alt, v);
                 }
-
-              mst.erase(mst.begin() + i);
-              is_found = true;
-              --i;
-              --end;
             }
         }
 
-      if(!is_found)
+      if(reached == 0)
         {
           break;
         }
+
+      for(uint32_t node = reached; dist[node] != 0;)
+        {
+          const graph::Edge edge = prev[node];
+
+          uf.union_sets(edge.m_source, edge.m_destination);
+          edges.push_back(edge);
+
+          node = edge.m_source == node ? edge.m_destination : edge.m_source;
+        }
     }
 
+  /** Overlapping subtrees may form cycles, keep the lightest spanning tree of the collected edges */
+  std::sort(edges.begin(), edges.end(), [](const graph::Edge& lhs, const graph::Edge& rhs) { return lhs.m_weight < rhs.m_weight; });
+
+  details::UnionFind                          tree_uf(nodes.size() + 1);
+  std::vector<graph::Edge>                    mst;
+  std::pmr::unordered_map<uint32_t, uint32_t> mst_nodes(&workspaces[worker].m_memory);
+
+  for(const auto& edge : edges)
+    {
+      if(tree_uf.union_sets(edge.m_source, edge.m_destination))
+        {
+          mst_nodes[edge.m_destination] += 1;
+          mst_nodes[edge.m_source] += 1;
+
+          mst.push_back(edge);
+        }
+    }
+
+  details::prune_leaves(mst, mst_nodes, terminals);
+
   std::vector<std::pair<uint32_t, uint32_t>> final_mst;
 
   for(const auto& edge : mst)
@@ -384,4 +670,8 @@ dijkstra_kruskal_greedy(const graph::Graph& graph)
   return final_mst;
 }
 
+template std::vector<std::pair<uint32_t, uint32_t>> tiled_dijkstra_kruskal_greedy<uint8_t>(const graph::Graph&, const std::vector<matrix::Coordinates<uint8_t>>&, const uint32_t, const uint32_t, utils::TaskPool&, const std::size_t, std::vector<Workspace>&);
+template std::vector<std::pair<uint32_t, uint32_t>> tiled_dijkstra_kruskal_greedy<uint16_t>(const graph::Graph&, const std::vector<matrix::Coordinates<uint16_t>>&, const uint32_t, const uint32_t, utils::TaskPool&, const std::size_t, std::vector<Workspace>&);
+template std::vector<std::pair<uint32_t, uint32_t>> tiled_dijkstra_kruskal_greedy<uint32_t>(const graph::Graph&, const std::vector<matrix::Coordinates<uint32_t>>&, const uint32_t, const uint32_t, utils::TaskPool&, const std::size_t, std::vector<Workspace>&);
+
 } // namespace algorithms
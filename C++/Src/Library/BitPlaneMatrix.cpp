@@ -0,0 +1,279 @@
+#include <bit>
+#include <string>
+
+#include "Include/BitPlaneMatrix.hpp"
+#include "Include/Types.hpp"
+
+namespace matrix
+{
+/** =============================== CONSTRUCTORS ================================= */
+
+template <typename Extent>
+BasicBitPlaneMatrix<Extent>::BasicBitPlaneMatrix(const Shape& shape)
+    : m_shape(shape), m_words((std::size_t(shape.m_x) + 63) / 64)
+{
+  for(auto& plane : m_planes)
+    {
+      plane.assign(std::size_t(m_shape.m_y) * m_shape.m_z * m_words, 0);
+    }
+}
+
+template <typename Extent>
+BasicBitPlaneMatrix<Extent>::BasicBitPlaneMatrix(const BasicMatrix<Extent>& matrix)
+    : BasicBitPlaneMatrix(matrix.shape())
+{
+  const auto view = matrix.view();
+
+  for(Extent z = 0; z < m_shape.m_z; ++z)
+    {
+      for(Extent y = 0; y < m_shape.m_y; ++y)
+        {
+          Extent x = 0;
+
+          for(const uint8_t value : view.row(y, z))
+            {
+              if(value != 0)
+                {
+                  set_at(value, x, y, z);
+                }
+
+              ++x;
+            }
+        }
+    }
+}
+
+/** =============================== PUBLIC METHODS =============================== */
+
+template <typename Extent>
+const typename BasicBitPlaneMatrix<Extent>::Shape&
+BasicBitPlaneMatrix<Extent>::shape() const
+{
+  return m_shape;
+}
+
+template <typename Extent>
+uint8_t
+BasicBitPlaneMatrix<Extent>::get_at(const Extent x, const Extent y, const Extent z) const
+{
+  if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
+    {
+      throw std::out_of_range("Out of range");
+    }
+
+  const std::size_t word = row_of(y, z) + x / 64;
+  const uint64_t    bit  = uint64_t(1) << (x % 64);
+
+  for(std::size_t p = 0; p < s_planes; ++p)
+    {
+      if(m_planes[p][word] & bit)
+        {
+          return p + 1;
+        }
+    }
+
+  return 0;
+}
+
+template <typename Extent>
+void
+BasicBitPlaneMatrix<Extent>::set_at(const uint8_t value, const Extent x, const Extent y, const Extent z)
+{
+  if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
+    {
+      throw std::out_of_range("Out of range");
+    }
+
+  if(value > s_planes)
+    {
+      throw std::invalid_argument("Unknown cell class " + std::to_string(value));
+    }
+
+  const std::size_t word = row_of(y, z) + x / 64;
+  const uint64_t    bit  = uint64_t(1) << (x % 64);
+
+  for(std::size_t p = 0; p < s_planes; ++p)
+    {
+      m_planes[p][word] = p + 1 == value ? m_planes[p][word] | bit : m_planes[p][word] & ~bit;
+    }
+}
+
+template <typename Extent>
+void
+BasicBitPlaneMatrix<Extent>::fill_row(const Extent y, const Extent z, const uint8_t crossing_value)
+{
+  const std::size_t row       = row_of(y, z);
+  const uint64_t    last_mask = m_shape.m_x % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (m_shape.m_x % 64)) - 1;
+
+  auto              occupied  = [&](const std::size_t w) {
+    uint64_t bits = 0;
+
+    for(const auto& plane : m_planes)
+      {
+        bits |= plane[row + w];
+      }
+
+    return bits;
+  };
+
+  auto valid = [&](const std::size_t w) {
+    return w + 1 == m_words ? last_mask : ~uint64_t(0);
+  };
+
+  bool is_free = false;
+
+  for(std::size_t w = 0; w < m_words && !is_free; ++w)
+    {
+      is_free = (~occupied(w) & valid(w)) != 0;
+    }
+
+  if(!is_free)
+    {
+      return;
+    }
+
+  auto& trace     = m_planes[types::TRACE_CELL - 1];
+  auto& terminals = m_planes[types::TERMINAL_CELL - 1];
+
+  for(std::size_t w = 0; w < m_words; ++w)
+    {
+      const uint64_t bits     = occupied(w);
+      const uint64_t crossing = bits & ~terminals[row + w];
+
+      for(std::size_t p = 0; p < s_planes; ++p)
+        {
+          m_planes[p][row + w] &= ~crossing;
+        }
+
+      m_planes[crossing_value - 1][row + w] |= crossing;
+      trace[row + w] |= ~bits & valid(w);
+    }
+}
+
+template <typename Extent>
+void
+BasicBitPlaneMatrix<Extent>::fill_column(const Extent x, const Extent z, const uint8_t crossing_value)
+{
+  const std::size_t first = row_of(0, z) + x / 64;
+
+  fill_cells(
+      m_shape.m_y, [&](const std::size_t y) { return first + y * m_words; }, uint64_t(1) << (x % 64), crossing_value);
+}
+
+template <typename Extent>
+void
+BasicBitPlaneMatrix<Extent>::fill_pillar(const Extent x, const Extent y, const uint8_t crossing_value)
+{
+  const std::size_t first = row_of(y, 0) + x / 64;
+
+  fill_cells(
+      m_shape.m_z, [&](const std::size_t z) { return first + z * m_shape.m_y * m_words; }, uint64_t(1) << (x % 64), crossing_value);
+}
+
+template <typename Extent>
+void
+BasicBitPlaneMatrix<Extent>::to_matrix(BasicMatrix<Extent>& matrix) const
+{
+  matrix.fill(0);
+
+  /** Strides of the matrix layout, depth is the innermost axis and is stored reversed */
+  const std::size_t x_stride = m_shape.m_z;
+  const std::size_t y_stride = std::size_t(m_shape.m_y) * m_shape.m_z;
+
+  uint8_t*          data     = matrix.data();
+
+  for(Extent z = 0; z < m_shape.m_z; ++z)
+    {
+      for(Extent y = 0; y < m_shape.m_y; ++y)
+        {
+          uint8_t*          row   = data + y * y_stride + (m_shape.m_z - z - 1);
+          const std::size_t first = row_of(y, z);
+
+          for(std::size_t w = 0; w < m_words; ++w)
+            {
+              for(std::size_t p = 0; p < s_planes; ++p)
+                {
+                  for(uint64_t bits = m_planes[p][first + w]; bits != 0; bits &= bits - 1)
+                    {
+                      row[(w * 64 + std::countr_zero(bits)) * x_stride] = p + 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename Extent>
+BasicMatrix<Extent>
+BasicBitPlaneMatrix<Extent>::to_matrix() const
+{
+  BasicMatrix<Extent> matrix(m_shape);
+  to_matrix(matrix);
+
+  return matrix;
+}
+
+/** =============================== PRIVATE METHODS ============================== */
+
+template <typename Extent>
+std::size_t
+BasicBitPlaneMatrix<Extent>::row_of(const Extent y, const Extent z) const
+{
+  return (std::size_t(z) * m_shape.m_y + y) * m_words;
+}
+
+template <typename Extent>
+template <typename Word>
+void
+BasicBitPlaneMatrix<Extent>::fill_cells(const std::size_t length, Word&& word, const uint64_t bit, const uint8_t crossing_value)
+{
+  auto occupied = [&](const std::size_t i) {
+    bool is_occupied = false;
+
+    for(const auto& plane : m_planes)
+      {
+        is_occupied |= (plane[word(i)] & bit) != 0;
+      }
+
+    return is_occupied;
+  };
+
+  bool is_free = false;
+
+  for(std::size_t i = 0; i < length && !is_free; ++i)
+    {
+      is_free = !occupied(i);
+    }
+
+  if(!is_free)
+    {
+      return;
+    }
+
+  for(std::size_t i = 0; i < length; ++i)
+    {
+      const std::size_t w = word(i);
+
+      if(!occupied(i))
+        {
+          m_planes[types::TRACE_CELL - 1][w] |= bit;
+        }
+      else if((m_planes[types::TERMINAL_CELL - 1][w] & bit) == 0)
+        {
+          for(auto& plane : m_planes)
+            {
+              plane[w] &= ~bit;
+            }
+
+          m_planes[crossing_value - 1][w] |= bit;
+        }
+    }
+}
+
+/** =============================== INSTANTIATIONS =============================== */
+
+template class BasicBitPlaneMatrix<uint8_t>;
+template class BasicBitPlaneMatrix<uint16_t>;
+template class BasicBitPlaneMatrix<uint32_t>;
+
+} // namespace matrix
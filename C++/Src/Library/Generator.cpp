@@ -2,6 +2,8 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <numeric>
+#include <ranges>
 #include <stdexcept>
 #include <thread>
 #include <tuple>
@@ -16,35 +18,29 @@ namespace details
 {
 
 /**
- * @brief Generates next lexicographical combination.
+ * @brief Finalizer of SplitMix64, every bit of the result depends on every bit of the value.
  *
- * @param combinations Combinations.
- * @param length The size of sequence
- * @param number_of_points The number of points.
+ * @param value The value to mix.
+ * @return uint64_t
  */
-void
-next_combination(std::vector<uint32_t>& combinations, const uint32_t length, const uint8_t number_of_points, uint64_t idx)
+uint64_t
+mix(uint64_t value)
 {
-  uint32_t x = 0;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
 
-  for(uint8_t i = 0; i < number_of_points; ++i)
-    {
-      uint64_t binom;
+  return value ^ (value >> 31);
+}
 
-      while((binom = nCr(length - x - 1, number_of_points - i - 1)) <= idx)
-        {
-          ++x;
-          idx -= binom;
-        }
+/** Increment of the SplitMix64 counter */
+constexpr uint64_t s_golden_gamma = 0x9e3779b97f4a7c15ull;
 
-      combinations[i] = x;
-      ++x;
-    }
-}
+/** Most coefficients a binomial table keeps, 64 MiB of ranks */
+constexpr std::size_t s_max_table_entries = std::size_t(1) << 22;
 
 } // namespace details
 
-uint64_t
+Rank
 nCr(uint32_t n, uint32_t r)
 {
   if(r > n)
@@ -62,44 +58,217 @@ nCr(uint32_t n, uint32_t r)
       r = n - r;
     }
 
-  uint64_t result = 1;
+  Rank result = 1;
 
   for(uint32_t i = 1; i <= r; ++i)
     {
-      result *= n - i + 1;
-      result /= i;
+      /** The product result * (n - i + 1) is divisible by i, reducing first keeps it in range while the result fits */
+      const uint32_t common = std::gcd(uint32_t(result % i), i);
+
+      if(__builtin_mul_overflow(result / common, (n - i + 1) / (i / common), &result))
+        {
+          throw std::overflow_error("Generator Error: The number of combinations doesn't fit 128 bits.");
+        }
     }
 
   return result;
 }
 
+/**********************************************************************************
+ *                               BinomialTable class                              *
+ **********************************************************************************/
+
+/** =============================== CONSTRUCTORS ================================= */
+
+BinomialTable::BinomialTable(const uint32_t length, const uint8_t number_of_points)
+    : m_length(length), m_number_of_points(number_of_points), m_table()
+{
+  const std::size_t rows = std::size_t(length) + 1;
+
+  /** Past the budget the coefficients are computed when they are needed, the largest of them must still fit */
+  if((std::size_t(number_of_points) + 1) * rows > details::s_max_table_entries)
+    {
+      gen::nCr(length, std::min<uint32_t>(number_of_points, length / 2));
+      return;
+    }
+
+  m_table.assign((std::size_t(number_of_points) + 1) * rows, 0);
+
+  /** nC0 is 1, every other column follows n-1Cr-1 + n-1Cr */
+  std::fill(m_table.begin(), m_table.begin() + rows, 1);
+
+  for(std::size_t r = 1; r <= number_of_points; ++r)
+    {
+      const Rank* previous = m_table.data() + (r - 1) * rows;
+      Rank*       current  = m_table.data() + r * rows;
+
+      for(std::size_t n = 1; n < rows; ++n)
+        {
+          if(__builtin_add_overflow(previous[n - 1], current[n - 1], &current[n]))
+            {
+              throw std::overflow_error("Generator Error: The number of combinations doesn't fit 128 bits.");
+            }
+        }
+    }
+}
+
+/** =============================== PUBLIC METHODS =============================== */
+
+Rank
+BinomialTable::nCr(const uint32_t n, const uint8_t r) const
+{
+  return m_table.empty() ? gen::nCr(n, r) : m_table[std::size_t(r) * (std::size_t(m_length) + 1) + n];
+}
+
+void
+BinomialTable::unrank(std::vector<uint32_t>& combination, Rank rank) const
+{
+  unrank(combination, rank, 0);
+}
+
+void
+BinomialTable::advance(std::vector<uint32_t>& combination, const Rank step) const
+{
+  const uint8_t number_of_points = uint8_t(combination.size());
+
+  if(step == 1)
+    {
+      /** The last point that can still move moves by one, the ones after it follow it */
+      uint8_t i = number_of_points - 1;
+
+      while(combination[i] == m_length - number_of_points + i)
+        {
+          --i;
+        }
+
+      ++combination[i];
+
+      for(uint8_t j = i + 1; j < number_of_points; ++j)
+        {
+          combination[j] = combination[j - 1] + 1;
+        }
+
+      return;
+    }
+
+  /** Rank of the suffix among the combinations sharing the points before it, growing from the back */
+  Rank suffix = 0;
+
+  for(uint8_t i = number_of_points; i-- > 0;)
+    {
+      const uint32_t first = i == 0 ? 0 : combination[i - 1] + 1;
+      const uint8_t  r     = number_of_points - i;
+      const Rank     total = nCr(m_length - first, r);
+
+      suffix += total - nCr(m_length - combination[i], r);
+
+      if(step < total - suffix)
+        {
+          unrank(combination, suffix + step, i);
+          return;
+        }
+    }
+}
+
+uint32_t
+BinomialTable::length() const
+{
+  return m_length;
+}
+
+uint8_t
+BinomialTable::number_of_points() const
+{
+  return m_number_of_points;
+}
+
+/** =============================== PRIVATE METHODS ============================== */
+
+void
+BinomialTable::unrank(std::vector<uint32_t>& combination, Rank rank, const uint8_t position) const
+{
+  const uint8_t number_of_points = uint8_t(combination.size());
+  uint32_t      x                = position == 0 ? 0 : combination[position - 1] + 1;
+
+  for(uint8_t i = position; i + 1 < number_of_points; ++i)
+    {
+      /**
+       * Combinations with the i-th point in [x, y) number n-xCr - n-yCr with r the points
+       * left including this one, so the point is at the smallest n-y whose column value
+       * stays at least n-xCr - rank.
+       */
+      const uint8_t  r     = number_of_points - i;
+      const Rank     total = nCr(m_length - x, r);
+      const uint32_t rest  = lower_bound(r, m_length - x, total - rank);
+
+      rank -= total - nCr(rest, r);
+      x              = m_length - rest;
+      combination[i] = x;
+      ++x;
+    }
+
+  /** The last point alone is one combination per position */
+  if(position < number_of_points)
+    {
+      combination[number_of_points - 1] = x + uint32_t(rank);
+    }
+}
+
+uint32_t
+BinomialTable::lower_bound(const uint8_t r, const uint32_t n, const Rank value) const
+{
+  if(m_table.empty())
+    {
+      return *std::ranges::lower_bound(std::views::iota(uint32_t(0), n + 1), value, {}, [r](const uint32_t k) { return gen::nCr(k, r); });
+    }
+
+  const Rank* column = m_table.data() + std::size_t(r) * (std::size_t(m_length) + 1);
+
+  return uint32_t(std::lower_bound(column, column + n + 1, value) - column);
+}
+
 /**********************************************************************************
  *                               GeneratorItr class                               *
  **********************************************************************************/
 
 /** =============================== CONSTRUCTORS ================================= */
 
-GeneratorItr::GeneratorItr(uint32_t length, uint8_t number_of_points, uint64_t step, const uint64_t start, const uint64_t end)
-    : m_length(length), m_number_of_points(number_of_points), m_step(step), m_start(start), m_end(end), m_combination()
+GeneratorItr::GeneratorItr(uint32_t length, uint8_t number_of_points, Rank step, const Rank start, const Rank end)
+    : GeneratorItr(start < end ? std::make_shared<const BinomialTable>(length, number_of_points) : nullptr, number_of_points, step, start, end)
 {
-  m_combination.resize(number_of_points, 0);
-  details::next_combination(m_combination, m_length, m_number_of_points, m_start);
-};
+}
+
+GeneratorItr::GeneratorItr(std::shared_ptr<const BinomialTable> table, const uint8_t number_of_points, const Rank step, const Rank start, const Rank end)
+    : m_table(std::move(table)), m_step(step), m_start(start), m_end(end), m_combination()
+{
+  /** End iterators are only compared, they are never unranked */
+  if(m_start < m_end)
+    {
+      m_combination.resize(number_of_points, 0);
+      m_table->unrank(m_combination, m_start);
+    }
+}
 
 /** =============================== OPERATORS ==================================== */
 
 GeneratorItr&
 GeneratorItr::operator++()
 {
-  if(m_start += m_step; m_start < m_end)
+  /** Ranks near the end of the space must not wrap around */
+  if(m_end - m_start > m_step)
     {
-      details::next_combination(m_combination, m_length, m_number_of_points, m_start);
+      m_start += m_step;
+      m_table->advance(m_combination, m_step);
+    }
+  else
+    {
+      m_start = m_end;
     }
 
   return *this;
 }
 
-std::vector<uint32_t>
+std::span<const uint32_t>
 GeneratorItr::operator*() const
 {
   return m_combination;
@@ -111,5 +280,115 @@ GeneratorItr::operator<(const GeneratorItr& other) const
   return m_start < other.m_start && m_end == other.m_end;
 }
 
+/**********************************************************************************
+ *                               CounterRng class                                 *
+ **********************************************************************************/
+
+/** =============================== CONSTRUCTORS ================================= */
+
+CounterRng::CounterRng(const uint64_t seed, const uint64_t stream)
+    : m_key(details::mix(details::mix(seed + details::s_golden_gamma) ^ (stream * details::s_golden_gamma)))
+{
+}
+
+/** =============================== PUBLIC METHODS =============================== */
+
+uint64_t
+CounterRng::operator()()
+{
+  return details::mix(m_key + ++m_counter * details::s_golden_gamma);
+}
+
+uint64_t
+CounterRng::below(const uint64_t bound)
+{
+  /** Multiply and shift, the few low products that would bias the result are drawn again */
+  unsigned __int128 product   = static_cast<unsigned __int128>((*this)()) * bound;
+  const uint64_t    threshold = (0 - bound) % bound;
+
+  while(uint64_t(product) < threshold)
+    {
+      product = static_cast<unsigned __int128>((*this)()) * bound;
+    }
+
+  return uint64_t(product >> 64);
+}
+
+void
+random_combination(std::vector<uint32_t>& combination, const uint32_t length, CounterRng& random)
+{
+  const std::size_t number_of_points = combination.size();
+  std::size_t       count            = 0;
+
+  /** Floyd: a draw from [0, j] that is already taken takes j instead, which is never taken before */
+  for(uint32_t j = length - uint32_t(number_of_points); j < length; ++j)
+    {
+      const uint32_t value = uint32_t(random.below(uint64_t(j) + 1));
+
+      combination[count] = std::find(combination.begin(), combination.begin() + count, value) == combination.begin() + count ? value : j;
+      ++count;
+    }
+
+  std::sort(combination.begin(), combination.end());
+}
+
+/**********************************************************************************
+ *                               RandomItr class                                  *
+ **********************************************************************************/
+
+/** =============================== CONSTRUCTORS ================================= */
+
+RandomItr::RandomItr(const uint32_t length, const uint8_t number_of_points, const uint64_t seed, const uint64_t start, const uint64_t end)
+    : m_length(length), m_number_of_points(number_of_points), m_seed(seed), m_sample(start), m_end(number_of_points > length ? start : end), m_combination(number_of_points, 0)
+{
+  /** There are no combinations of more points than the length, like in the lexicographical order */
+  if(m_sample < m_end)
+    {
+      draw();
+    }
+}
+
+/** =============================== OPERATORS ==================================== */
+
+RandomItr&
+RandomItr::operator++()
+{
+  if(++m_sample < m_end)
+    {
+      draw();
+    }
+
+  return *this;
+}
+
+std::span<const uint32_t>
+RandomItr::operator*() const
+{
+  return m_combination;
+}
+
+bool
+RandomItr::operator<(const RandomItr& other) const
+{
+  return m_sample < other.m_sample && m_end == other.m_end;
+}
+
+/** =============================== PUBLIC METHODS =============================== */
+
+uint64_t
+RandomItr::sample() const
+{
+  return m_sample;
+}
+
+/** =============================== PRIVATE METHODS ============================== */
+
+void
+RandomItr::draw()
+{
+  /** Samples of different numbers of points come from different streams */
+  CounterRng random(m_seed, m_sample << 8 | m_number_of_points);
+  random_combination(m_combination, m_length, random);
+}
 
 } // namespace gen
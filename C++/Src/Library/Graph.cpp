@@ -2,6 +2,7 @@
 #include <numeric>
 #include <queue>
 #include <unordered_map>
+#include <utility>
 
 #include "Include/Graph.hpp"
 
@@ -29,7 +30,14 @@ operator==(const Edge& lhs, const Edge& rhs)
 void
 Graph::place_node()
 {
-  m_adj.push_back({});
+  if(m_spare.empty())
+    {
+      m_adj.push_back({});
+      return;
+    }
+
+  m_adj.push_back(std::move(m_spare.back()));
+  m_spare.pop_back();
 }
 
 void
@@ -58,6 +66,22 @@ Graph::add_edge(uint32_t weight, uint32_t source, uint32_t destination)
     }
 }
 
+void
+Graph::clear()
+{
+  /** Emptied adjacency lists are kept for the next nodes along with their capacity */
+  for(auto& edges : m_adj)
+    {
+      edges.clear();
+      m_spare.push_back(std::move(edges));
+    }
+
+  m_adj.clear();
+
+  /** Clearing keeps the buckets, which would change the order of the next terminals and so the ties of the solver */
+  std::unordered_set<uint32_t>{}.swap(m_terminals);
+}
+
 const std::vector<std::vector<Edge>>&
 Graph::get_adj() const
 {
@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "Include/Kernels.hpp"
+#include "Include/Types.hpp"
+
+namespace kernels
+{
+
+bool
+contains(const uint8_t* data, const std::size_t length, const uint8_t value)
+{
+  /** Blocks without early exit vectorize, the search still stops at the first block with a hit */
+  for(std::size_t i = 0; i < length; i += 64)
+    {
+      const std::size_t end   = std::min<std::size_t>(length, i + 64);
+      uint8_t           found = 0;
+
+      for(std::size_t j = i; j < end; ++j)
+        {
+          found |= data[j] == value;
+        }
+
+      if(found != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+void
+fill_line(uint8_t* data, const std::size_t length, const uint8_t crossing_value)
+{
+  /** Branchless, so that it vectorizes */
+  for(std::size_t i = 0; i < length; ++i)
+    {
+      const uint8_t value = data[i];
+      data[i]             = value == 0 ? types::TRACE_CELL : (value == types::TERMINAL_CELL ? value : crossing_value);
+    }
+}
+
+} // namespace kernels
@@ -1,11 +1,14 @@
+#include <cstring>
+
 #include "Include/Matrix.hpp"
 
 namespace matrix
 {
 /** =============================== CONSTRUCTORS ================================= */
 
-Matrix::Matrix(const Shape& shape)
-    : m_shape(shape), m_data(nullptr)
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>::BasicMatrix(const Shape& shape)
+    : m_shape(shape), m_layout(shape), m_data(nullptr)
 {
   const std::size_t length = allocate();
 
@@ -15,13 +18,15 @@ Matrix::Matrix(const Shape& shape)
     }
 };
 
-Matrix::~Matrix()
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>::~BasicMatrix()
 {
   delete[] m_data;
 }
 
-Matrix::Matrix(const Matrix& matrix)
-    : m_shape(matrix.m_shape), m_data(nullptr)
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>::BasicMatrix(const BasicMatrix& matrix)
+    : m_shape(matrix.m_shape), m_layout(matrix.m_layout), m_data(nullptr)
 {
   const std::size_t length = allocate();
 
@@ -31,21 +36,25 @@ Matrix::Matrix(const Matrix& matrix)
     }
 }
 
-Matrix::Matrix(Matrix&& matrix)
-    : m_shape(matrix.m_shape), m_data(matrix.m_data)
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>::BasicMatrix(BasicMatrix&& matrix)
+    : m_shape(matrix.m_shape), m_layout(matrix.m_layout), m_data(matrix.m_data)
 {
-  matrix.m_data  = nullptr;
-  matrix.m_shape = Shape{ 0, 0, 0 };
+  matrix.m_data   = nullptr;
+  matrix.m_shape  = Shape{ 0, 0, 0 };
+  matrix.m_layout = Layout();
 }
 
 /** =============================== OPERATORS ==================================== */
 
-Matrix&
-Matrix::operator=(const Matrix& matrix)
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>&
+BasicMatrix<Extent, Layout>::operator=(const BasicMatrix& matrix)
 {
   clear();
 
   m_shape                  = matrix.m_shape;
+  m_layout                 = matrix.m_layout;
 
   const std::size_t length = allocate();
 
@@ -57,74 +66,115 @@ Matrix::operator=(const Matrix& matrix)
   return *this;
 }
 
-Matrix&
-Matrix::operator=(Matrix&& matrix)
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>&
+BasicMatrix<Extent, Layout>::operator=(BasicMatrix&& matrix)
 {
-  m_shape        = matrix.m_shape;
-  m_data         = matrix.m_data;
-  matrix.m_data  = nullptr;
-  matrix.m_shape = Shape{ 0, 0, 0 };
+  m_shape         = matrix.m_shape;
+  m_layout        = matrix.m_layout;
+  m_data          = matrix.m_data;
+  matrix.m_data   = nullptr;
+  matrix.m_shape  = Shape{ 0, 0, 0 };
+  matrix.m_layout = Layout();
 
   return *this;
 }
 
 /** =============================== PUBLIC METHODS =============================== */
 
+template <typename Extent, typename Layout>
 uint8_t*
-Matrix::data()
+BasicMatrix<Extent, Layout>::data()
 {
   return m_data;
 }
 
+template <typename Extent, typename Layout>
 const uint8_t*
-Matrix::data() const
+BasicMatrix<Extent, Layout>::data() const
 {
   return m_data;
 }
 
-const Shape&
-Matrix::shape() const
+template <typename Extent, typename Layout>
+const typename BasicMatrix<Extent, Layout>::Shape&
+BasicMatrix<Extent, Layout>::shape() const
 {
   return m_shape;
 }
 
+template <typename Extent, typename Layout>
 const uint8_t&
-Matrix::get_at(const uint8_t x, const uint8_t y, const uint8_t z) const
+BasicMatrix<Extent, Layout>::get_at(const Extent x, const Extent y, const Extent z) const
 {
   if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
     {
       throw std::out_of_range("Out of range");
     }
 
-  const std::size_t index = y * m_shape.m_y * m_shape.m_z + x * m_shape.m_z + (m_shape.m_z - z - 1);
-  return m_data[index];
+  return m_data[m_layout.index(x, y, z)];
 }
 
+template <typename Extent, typename Layout>
 void
-Matrix::set_at(const uint8_t value, const uint8_t x, const uint8_t y, const uint8_t z)
+BasicMatrix<Extent, Layout>::set_at(const uint8_t value, const Extent x, const Extent y, const Extent z)
 {
   if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
     {
       throw std::out_of_range("Out of range");
     }
 
-  const std::size_t index = y * m_shape.m_y * m_shape.m_z + x * m_shape.m_z + (m_shape.m_z - z - 1);
-  m_data[index]           = value;
+  m_data[m_layout.index(x, y, z)] = value;
+}
+
+template <typename Extent, typename Layout>
+BasicMatrix<Extent>
+BasicMatrix<Extent, Layout>::to_row_major() const
+{
+  BasicMatrix<Extent> matrix(m_shape);
+
+  for_each([&](const Extent x, const Extent y, const Extent z, const uint8_t value) { matrix.set_at(value, x, y, z); });
+
+  return matrix;
+}
+
+template <typename Extent, typename Layout>
+BasicMatrix<Extent, Layout>
+BasicMatrix<Extent, Layout>::from_row_major(const BasicMatrix<Extent>& matrix)
+{
+  BasicMatrix converted(matrix.shape());
+
+  converted.for_each([&](const Extent x, const Extent y, const Extent z, uint8_t& value) { value = matrix.get_at(x, y, z); });
+
+  return converted;
 }
 
+template <typename Extent, typename Layout>
 void
-Matrix::clear() noexcept(true)
+BasicMatrix<Extent, Layout>::fill(const uint8_t value) noexcept(true)
 {
-  m_shape = Shape{ 0, 0, 0 };
+  if(m_data != nullptr)
+    {
+      std::memset(m_data, value, m_layout.size());
+    }
+}
+
+template <typename Extent, typename Layout>
+void
+BasicMatrix<Extent, Layout>::clear() noexcept(true)
+{
+  m_shape  = Shape{ 0, 0, 0 };
+  m_layout = Layout();
   delete[] m_data;
 }
 
 /** =============================== PRIVATE METHODS ============================== */
 
+template <typename Extent, typename Layout>
 std::size_t
-Matrix::allocate()
+BasicMatrix<Extent, Layout>::allocate()
 {
-  const std::size_t length = m_shape.m_z * m_shape.m_y * m_shape.m_x;
+  const std::size_t length = m_layout.size();
 
   if(length != 0)
     {
@@ -139,4 +189,18 @@ Matrix::allocate()
   return length;
 }
 
+/** =============================== INSTANTIATIONS =============================== */
+
+template class BasicMatrix<uint8_t>;
+template class BasicMatrix<uint16_t>;
+template class BasicMatrix<uint32_t>;
+
+template class BasicMatrix<uint8_t, MortonLayout>;
+template class BasicMatrix<uint16_t, MortonLayout>;
+template class BasicMatrix<uint32_t, MortonLayout>;
+
+template class BasicMatrix<uint8_t, BrickLayout<>>;
+template class BasicMatrix<uint16_t, BrickLayout<>>;
+template class BasicMatrix<uint32_t, BrickLayout<>>;
+
 } // namespace matrix
@@ -0,0 +1,270 @@
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Include/Numpy.hpp"
+
+namespace numpy
+{
+
+namespace details
+{
+
+/**
+ * @brief Returns the value of the key in the header dictionary, starting past its colon
+ * and any spaces.
+ *
+ * @param header The header dictionary.
+ * @param key The key without quotes.
+ * @return std::string_view
+ */
+std::string_view
+find_value(const std::string_view header, const std::string_view key)
+{
+  std::string quoted_key;
+
+  /** Appended onto a reserved string, "'" + std::string(key) trips a false -Wrestrict of GCC 12 */
+  quoted_key.reserve(key.size() + 3);
+  quoted_key.append("'").append(key).append("':");
+
+  const std::size_t position = header.find(quoted_key);
+
+  if(position == std::string_view::npos)
+    {
+      throw std::runtime_error("Numpy Error: The header has no '" + std::string(key) + "' key.");
+    }
+
+  std::string_view value = header.substr(position + key.size() + 3);
+  value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+
+  return value;
+}
+
+} // namespace details
+
+/** =============================== CONSTRUCTORS ================================= */
+
+MappedArray::MappedArray(const std::filesystem::path& file_path)
+{
+  const int file = ::open(file_path.c_str(), O_RDONLY);
+
+  if(file == -1)
+    {
+      throw std::runtime_error("Numpy Error: Failed to open the file \"" + file_path.string() + "\".");
+    }
+
+  struct stat status;
+
+  if(::fstat(file, &status) == -1 || status.st_size == 0)
+    {
+      ::close(file);
+      throw std::runtime_error("Numpy Error: Failed to read the file \"" + file_path.string() + "\".");
+    }
+
+  void* mapping = ::mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+  /** The mapping holds its own reference to the file */
+  ::close(file);
+
+  if(mapping == MAP_FAILED)
+    {
+      throw std::runtime_error("Numpy Error: Failed to map the file \"" + file_path.string() + "\".");
+    }
+
+  m_mapping = static_cast<const char*>(mapping);
+  m_length  = std::size_t(status.st_size);
+
+  try
+    {
+      parse_header();
+    }
+  catch(...)
+    {
+      release();
+      throw;
+    }
+}
+
+MappedArray::~MappedArray()
+{
+  release();
+}
+
+MappedArray::MappedArray(MappedArray&& array) noexcept
+    : m_mapping(std::exchange(array.m_mapping, nullptr)), m_length(std::exchange(array.m_length, 0)), m_data(std::exchange(array.m_data, nullptr)), m_shape(std::move(array.m_shape)), m_size(std::exchange(array.m_size, 0)), m_kind(array.m_kind), m_item_size(array.m_item_size)
+{
+}
+
+/** =============================== OPERATORS ==================================== */
+
+MappedArray&
+MappedArray::operator=(MappedArray&& array) noexcept
+{
+  if(this != &array)
+    {
+      release();
+
+      m_mapping   = std::exchange(array.m_mapping, nullptr);
+      m_length    = std::exchange(array.m_length, 0);
+      m_data      = std::exchange(array.m_data, nullptr);
+      m_shape     = std::move(array.m_shape);
+      m_size      = std::exchange(array.m_size, 0);
+      m_kind      = array.m_kind;
+      m_item_size = array.m_item_size;
+    }
+
+  return *this;
+}
+
+/** =============================== PUBLIC METHODS =============================== */
+
+const std::vector<std::size_t>&
+MappedArray::shape() const
+{
+  return m_shape;
+}
+
+std::size_t
+MappedArray::size() const
+{
+  return m_size;
+}
+
+char
+MappedArray::kind() const
+{
+  return m_kind;
+}
+
+std::size_t
+MappedArray::item_size() const
+{
+  return m_item_size;
+}
+
+const char*
+MappedArray::data() const
+{
+  return m_data;
+}
+
+/** =============================== PRIVATE METHODS ============================== */
+
+void
+MappedArray::parse_header()
+{
+  /** Magic string, version, then the header length: 2 bytes in version 1, 4 bytes since version 2 */
+  if(m_length < 10 || std::memcmp(m_mapping, "\x93NUMPY", 6) != 0)
+    {
+      throw std::runtime_error("Numpy Error: The file is not a numpy array.");
+    }
+
+  const uint8_t major = uint8_t(m_mapping[6]);
+
+  if(major < 1 || major > 3 || (major > 1 && m_length < 12))
+    {
+      throw std::runtime_error("Numpy Error: Unsupported format version " + std::to_string(major) + ".");
+    }
+
+  std::size_t header_offset = 10;
+  std::size_t header_length = 0;
+
+  if(major == 1)
+    {
+      uint16_t length;
+      std::memcpy(&length, m_mapping + 8, sizeof(length));
+      header_length = length;
+    }
+  else
+    {
+      uint32_t length;
+      std::memcpy(&length, m_mapping + 8, sizeof(length));
+      header_length = length;
+      header_offset = 12;
+    }
+
+  if(header_offset + header_length > m_length)
+    {
+      throw std::runtime_error("Numpy Error: The header is truncated.");
+    }
+
+  const std::string_view header(m_mapping + header_offset, header_length);
+
+  /** Type descriptor: byte order, kind and size, e.g. '<u2' */
+  const std::string_view descr = details::find_value(header, "descr");
+  const std::size_t      end   = descr.find('\'', 1);
+
+  if(descr.empty() || descr.front() != '\'' || end == std::string_view::npos || end < 4)
+    {
+      throw std::runtime_error("Numpy Error: Malformed type descriptor.");
+    }
+
+  const char byte_order = descr[1];
+  m_kind                = descr[2];
+  m_item_size           = std::stoul(std::string(descr.substr(3, end - 3)));
+
+  if((m_kind != 'u' && m_kind != 'i' && m_kind != 'f') || m_item_size == 0)
+    {
+      throw std::runtime_error("Numpy Error: Unsupported data type.");
+    }
+
+  if(byte_order == '>' && m_item_size > 1)
+    {
+      throw std::runtime_error("Numpy Error: Big-endian arrays are not supported.");
+    }
+
+  if(!details::find_value(header, "fortran_order").starts_with("False"))
+    {
+      throw std::runtime_error("Numpy Error: Fortran ordered arrays are not supported.");
+    }
+
+  /** Shape is a tuple, a one dimensional one ends with a comma */
+  std::string_view shape = details::find_value(header, "shape");
+
+  if(shape.empty() || shape.front() != '(' || shape.find(')') == std::string_view::npos)
+    {
+      throw std::runtime_error("Numpy Error: Malformed shape.");
+    }
+
+  shape = shape.substr(1, shape.find(')') - 1);
+  m_size = 1;
+
+  while(!shape.empty())
+    {
+      const std::size_t      comma     = std::min(shape.find(','), shape.size());
+      const std::string_view dimension = shape.substr(0, comma);
+
+      if(dimension.find_first_not_of(' ') != std::string_view::npos)
+        {
+          m_shape.push_back(std::stoull(std::string(dimension)));
+          m_size *= m_shape.back();
+        }
+
+      shape.remove_prefix(std::min(comma + 1, shape.size()));
+    }
+
+  const std::size_t data_offset = header_offset + header_length;
+
+  if(m_size * m_item_size > m_length - data_offset)
+    {
+      throw std::runtime_error("Numpy Error: The payload is truncated.");
+    }
+
+  m_data = m_mapping + data_offset;
+}
+
+void
+MappedArray::release() noexcept
+{
+  if(m_mapping != nullptr)
+    {
+      ::munmap(const_cast<char*>(m_mapping), m_length);
+      m_mapping = nullptr;
+    }
+}
+
+} // namespace numpy
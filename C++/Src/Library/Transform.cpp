@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <memory_resource>
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 
+#include "Include/Kernels.hpp"
 #include "Include/Transform.hpp"
 
 namespace transform
@@ -17,167 +24,1348 @@ struct TupleHash
   std::size_t
   operator()(const T& t) const
   {
-    auto hash = std::hash<uint8_t>()(std::get<0>(t));
-    hash ^= std::hash<uint8_t>()(std::get<1>(t)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    hash ^= std::hash<uint8_t>()(std::get<2>(t)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    using Extent = std::tuple_element_t<0, T>;
+
+    auto hash    = std::hash<Extent>()(std::get<0>(t));
+    hash ^= std::hash<Extent>()(std::get<1>(t)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<Extent>()(std::get<2>(t)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
     return hash;
   }
 };
 
-} // namespace details
+/**
+ * @brief Returns the first clear bit of the line after the given position.
+ *
+ * @param line The line bits.
+ * @param extent The number of cells in the line.
+ * @param position The position to search from.
+ * @return int32_t The position of the bit or -1 if there is none.
+ */
+inline int32_t
+next_clear(const uint64_t* line, const uint32_t extent, const uint32_t position)
+{
+  for(uint32_t p = position + 1; p < extent;)
+    {
+      const uint64_t bits = ~line[p >> 6] >> (p & 63);
+
+      if(bits != 0)
+        {
+          p += std::countr_zero(bits);
+          return p < extent ? p : -1;
+        }
+
+      p = ((p >> 6) + 1) << 6;
+    }
+
+  return -1;
+}
 
-std::pair<graph::Graph, std::vector<std::tuple<uint8_t, uint8_t, uint8_t>>>
-matrix_to_graph(const matrix::Matrix& matrix, const std::tuple<uint8_t, uint8_t, uint8_t>& inital_state)
+/**
+ * @brief Returns the last clear bit of the line before the given position.
+ *
+ * @param line The line bits.
+ * @param position The position to search from.
+ * @return int32_t The position of the bit or -1 if there is none.
+ */
+inline int32_t
+prev_clear(const uint64_t* line, const uint32_t position)
 {
-  /** TODO: Add iterator for coordinates */
-  std::vector<std::tuple<uint8_t, uint8_t, uint8_t>>                                      nodes;
-  std::unordered_map<std::tuple<uint8_t, uint8_t, uint8_t>, uint32_t, details::TupleHash> node_map;
+  for(int32_t p = int32_t(position) - 1; p >= 0;)
+    {
+      const uint64_t bits = ~line[p >> 6] << (63 - (p & 63));
 
-  matrix::Shape                                                                           shape = matrix.shape();
-  graph::Graph                                                                            graph;
+      if(bits != 0)
+        {
+          return p - std::countl_zero(bits);
+        }
 
-  std::queue<std::tuple<uint8_t, uint8_t, uint8_t>>                                       queue;
+      p = ((p >> 6) << 6) - 1;
+    }
 
-  node_map[inital_state] = nodes.size();
-  nodes.emplace_back(inital_state);
+  return -1;
+}
 
-  queue.push(inital_state);
-  graph.place_node();
+/**
+ * @brief Calls the function with the depth class of the shape as a compile-time flag,
+ * std::true_type for a planar grid and std::false_type for a stacked one.
+ *
+ * @param shape The shape of the grid.
+ * @param function The function to call.
+ * @return decltype(auto) The result of the function.
+ */
+template <typename Extent, typename Function>
+decltype(auto)
+with_depth_class(const matrix::BasicShape<Extent>& shape, Function&& function)
+{
+  if(shape.m_z == 1)
+    {
+      return function(std::true_type{});
+    }
+
+  return function(std::false_type{});
+}
 
-  auto search_direction = [&](int8_t dx, int8_t dy, int8_t dz, const std::tuple<uint8_t, uint8_t, uint8_t>& front) {
-    auto [x, y, z] = front;
+/**
+ * @brief Trace and stop cells of a matrix packed as bitmasks per row, column and pillar.
+ * Planar masks have no pillars.
+ *
+ */
+template <typename Extent, bool Planar = false>
+class RayMasks
+{
+  using Words = std::pmr::vector<uint64_t>;
+
+public:
+  RayMasks(const matrix::BasicShape<Extent>& shape, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+      : m_shape(shape), m_trace{ Words(memory), Words(memory), Words(memory) }, m_stop{ Words(memory), Words(memory), Words(memory) }
+  {
+    m_extent[0] = m_shape.m_x;
+    m_extent[1] = m_shape.m_y;
+    m_extent[2] = m_shape.m_z;
 
-    uint8_t new_x  = x;
-    uint8_t new_y  = y;
-    uint8_t new_z  = z;
+    m_lines[0]  = std::size_t(m_shape.m_y) * m_shape.m_z;
+    m_lines[1]  = std::size_t(m_shape.m_x) * m_shape.m_z;
+    m_lines[2]  = std::size_t(m_shape.m_x) * m_shape.m_y;
 
-    while(true)
+    for(std::size_t axis = 0; axis < s_axes; ++axis)
       {
-        if((dx > 0 && new_x < shape.m_x - 1) || (dx < 0 && new_x > 0))
-          {
-            new_x += dx;
-          }
-        else if(dx != 0)
-          {
-            break;
-          }
+        m_words[axis] = (m_extent[axis] + 63) / 64;
+        m_trace[axis].assign(m_lines[axis] * m_words[axis], 0);
+        m_stop[axis].assign(m_lines[axis] * m_words[axis], 0);
+      }
+  }
 
-        if((dy > 0 && new_y < shape.m_y - 1) || dy < 0 && new_y > 0)
-          {
-            new_y += dy;
-          }
-        else if(dy != 0)
-          {
-            break;
-          }
+  RayMasks(const matrix::BasicMatrix<Extent>& matrix)
+      : RayMasks(matrix.shape())
+  {
+    const uint8_t* data = matrix.data();
 
-        if((dz > 0 && new_z < shape.m_z - 1) || dz < 0 && new_z > 0)
-          {
-            new_z += dz;
-          }
-        else if(dz != 0)
+    /** Walk the data in memory order, depth is the innermost and reversed axis */
+    for(uint32_t y = 0; y < m_shape.m_y; ++y)
+      {
+        for(uint32_t x = 0; x < m_shape.m_x; ++x)
           {
-            break;
+            for(int32_t z = m_shape.m_z - 1; z >= 0; --z, ++data)
+              {
+                const uint8_t value = *data;
+
+                if(value == types::TRACE_CELL)
+                  {
+                    set_trace(x, y, z);
+                  }
+                else if(value == types::INTERSECTION_VIA_CELL || value == types::INTERSECTION_CELL || value == types::TERMINAL_CELL)
+                  {
+                    set_stop(x, y, z);
+                  }
+              }
           }
+      }
+  }
 
-        const uint8_t& matrix_value = matrix.get_at(new_x, new_y, new_z);
+  /**
+   * @brief Casts a ray from the cell along the axis. The ray passes trace cells and
+   * stops at the first other cell.
+   *
+   * @param axis The axis of the ray (0 - x, 1 - y, 2 - z).
+   * @param direction The direction of the ray, 1 or -1.
+   * @param x X-coordinate of the origin.
+   * @param y Y-coordinate of the origin.
+   * @param z Z-coordinate of the origin.
+   * @return int32_t The axis coordinate of the hit cell or -1 if the ray isn't stopped by a node.
+   */
+  int32_t
+  cast(const uint8_t axis, const int8_t direction, const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+    const std::size_t line     = line_of(axis, x, y, z) * m_words[axis];
+    const uint32_t    position = axis == 0 ? x : (axis == 1 ? y : z);
 
-        if(matrix_value == types::INTERSECTION_VIA_CELL || matrix_value == types::INTERSECTION_CELL || matrix_value == types::TERMINAL_CELL)
-          {
-            const std::tuple<uint8_t, uint8_t, uint8_t> next_node = std::make_tuple(new_x, new_y, new_z);
-            uint32_t                                    dest_idx;
+    const int32_t     hit      = direction > 0 ? next_clear(m_trace[axis].data() + line, m_extent[axis], position)
+                                               : prev_clear(m_trace[axis].data() + line, position);
 
-            if(node_map.count(next_node) == 0)
-              {
-                node_map[next_node] = nodes.size();
-                dest_idx            = nodes.size();
+    if(hit < 0 || (m_stop[axis][line + (hit >> 6)] >> (hit & 63) & 1) == 0)
+      {
+        return -1;
+      }
 
-                nodes.push_back(next_node);
-                queue.push(next_node);
-              }
-            else
-              {
-                dest_idx = node_map[next_node];
-              }
+    return hit;
+  }
 
-            const uint32_t weight     = std::abs(dx != 0 ? new_x - x : (dy != 0 ? new_y - y : new_z - z));
-            const uint32_t source_idx = node_map[front];
+  /**
+   * @brief Marks the cell as a trace cell.
+   *
+   */
+  void
+  set_trace(const uint32_t x, const uint32_t y, const uint32_t z)
+  {
+    set(m_trace, x, y, z, true);
+  }
 
-            graph.place_node();
-            graph.add_edge(weight, source_idx, dest_idx);
+  /**
+   * @brief Marks the cell as an intersection or terminal cell.
+   *
+   */
+  void
+  set_stop(const uint32_t x, const uint32_t y, const uint32_t z)
+  {
+    set(m_trace, x, y, z, false);
+    set(m_stop, x, y, z, true);
+  }
 
-            if(matrix_value == types::TERMINAL_CELL)
-              {
-                graph.add_terminal(dest_idx);
-              }
+private:
+  std::size_t
+  line_of(const uint8_t axis, const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+    switch(axis)
+      {
+      case 0: return std::size_t(y) * m_shape.m_z + z;
+      case 1: return std::size_t(x) * m_shape.m_z + z;
+      default: return std::size_t(x) * m_shape.m_y + y;
+      }
+  }
 
-            break;
-          }
+  void
+  set(Words* masks, const uint32_t x, const uint32_t y, const uint32_t z, const bool value)
+  {
+    const uint32_t position[3] = { x, y, z };
 
-        if(matrix_value != types::TRACE_CELL)
-          {
-            break;
-          }
+    for(uint8_t axis = 0; axis < s_axes; ++axis)
+      {
+        uint64_t&      word = masks[axis][line_of(axis, x, y, z) * m_words[axis] + (position[axis] >> 6)];
+        const uint64_t bit  = uint64_t(1) << (position[axis] & 63);
+
+        word                = value ? word | bit : word & ~bit;
       }
-  };
+  }
 
-  while(!queue.empty())
+private:
+  static constexpr uint8_t s_axes = Planar ? 2 : 3; ///< Number of axes with lines.
+
+  matrix::BasicShape<Extent> m_shape;     ///< Shape of the source matrix.
+  uint32_t              m_extent[3]; ///< Number of cells along each axis.
+  std::size_t           m_lines[3];  ///< Number of lines along each axis.
+  std::size_t           m_words[3];  ///< Number of words per line along each axis.
+  Words                 m_trace[3];  ///< Trace cells of every line along each axis.
+  Words                 m_stop[3];   ///< Intersection and terminal cells of every line along each axis.
+};
+
+/**
+ * @brief Returns the coordinate of the cell along the axis.
+ *
+ */
+template <typename Extent>
+inline Extent
+coordinate(const uint8_t axis, const matrix::Coordinates<Extent>& cell)
+{
+  return axis == 0 ? std::get<0>(cell) : (axis == 1 ? std::get<1>(cell) : std::get<2>(cell));
+}
+
+/**
+ * @brief Returns the cell moved to the given coordinate along the axis.
+ *
+ */
+template <typename Extent>
+inline matrix::Coordinates<Extent>
+with_coordinate(const uint8_t axis, matrix::Coordinates<Extent> cell, const Extent value)
+{
+  (axis == 0 ? std::get<0>(cell) : (axis == 1 ? std::get<1>(cell) : std::get<2>(cell))) = value;
+  return cell;
+}
+
+/**
+ * @brief Checks if two cells lie on the same line along the axis.
+ *
+ */
+template <typename Extent>
+inline bool
+on_line(const uint8_t axis, const matrix::Coordinates<Extent>& lhs, const matrix::Coordinates<Extent>& rhs)
+{
+  return with_coordinate<Extent>(axis, lhs, 0) == with_coordinate<Extent>(axis, rhs, 0);
+}
+
+/**
+ * @brief Fills a line of the terrain if it still has an empty cell. Empty cells become
+ * trace cells and the other ones, except terminals, become crossings.
+ *
+ * @param line The line of the matrix.
+ * @param crossing_value The value of a cell where the line crosses another one.
+ */
+template <typename Line>
+void
+fill_line(const Line& line, const uint8_t crossing_value)
+{
+  /** Rows of a single layer are contiguous and go through the vectorized kernels */
+  if(line.stride() == 1)
     {
-      const auto front = queue.front();
-      queue.pop();
+      if(kernels::contains(line.data(), line.size(), 0))
+        {
+          kernels::fill_line(line.data(), line.size(), crossing_value);
+        }
+
+      return;
+    }
+
+  if(std::find(line.begin(), line.end(), 0) == line.end())
+    {
+      return;
+    }
+
+  for(auto& value : line)
+    {
+      if(value == 0)
+        {
+          value = types::TRACE_CELL;
+        }
+      else if(value != types::TERMINAL_CELL)
+        {
+          value = crossing_value;
+        }
+    }
+}
+
+/**
+ * @brief Access of a terminal that is blocked by its neighbours.
+ *
+ */
+struct Access
+{
+  bool   m_is_x_blocked       = false; ///< The terminal's x-line is blocked.
+  bool   m_is_y_blocked       = false; ///< The terminal's y-line is blocked.
+  int8_t m_x_access_direction = 0;     ///< Direction to the access cell along x.
+  int8_t m_y_access_direction = 0;     ///< Direction to the access cell along y.
+};
+
+/**
+ * @brief Applies the blocking rules to a terminal. A line of a terminal on an even
+ * coordinate is blocked by a terminal on an adjacent line.
+ *
+ * @param shape The shape of the terrain.
+ * @param terminals The terminals.
+ * @param i The index of the terminal.
+ * @return Access
+ */
+template <typename Extent>
+Access
+access_of(const matrix::BasicShape<Extent>& shape, const std::vector<matrix::Coordinates<Extent>>& terminals, const std::size_t i)
+{
+  const auto [c_x, c_y, c_z] = terminals[i];
+  Access     access;
+
+  for(std::size_t j = 0, end = terminals.size(); j < end; ++j)
+    {
+      if(i != j)
+        {
+          const auto [c_x_s, c_y_s, c_z_s] = terminals[j];
+
+          if(!access.m_is_y_blocked && std::abs(int64_t(c_x_s) - c_x) == 1)
+            {
+              if(c_x % 2 == 0)
+                {
+                  access.m_is_y_blocked       = true;
+                  access.m_x_access_direction = c_x_s < c_x ? (c_x > 0 ? -1 : 0) : (c_x < (shape.m_x - 1) ? 1 : 0);
+                }
+            }
+
+          if(!access.m_is_x_blocked && std::abs(int64_t(c_y_s) - c_y) == 1)
+            {
+              if(c_y % 2 == 0)
+                {
+                  access.m_is_x_blocked       = true;
+                  access.m_y_access_direction = c_y_s < c_y ? (c_y > 0 ? -1 : 0) : (c_y < (shape.m_y - 1) ? 1 : 0);
+                }
+            }
+        }
+
+      if(access.m_is_x_blocked && access.m_is_y_blocked)
+        {
+          break;
+        }
+    }
+
+  return access;
+}
+
+/**
+ * @brief Cells and lines written while laying out the trace terrain of terminals.
+ *
+ */
+template <typename Extent>
+struct Layout
+{
+  explicit Layout(std::pmr::memory_resource* memory)
+      : m_cells(memory), m_lines{ Lines(memory), Lines(memory), Lines(memory) }
+  {
+  }
+
+  using Lines = std::pmr::vector<matrix::Coordinates<Extent>>;
+
+  std::pmr::vector<std::pair<matrix::Coordinates<Extent>, uint8_t>> m_cells;    ///< Written cells with their values, in order of writing.
+  Lines                                                             m_lines[3]; ///< Filled lines along each axis, as the cell they were filled from.
+};
+
+/**
+ * @brief Checks if a line still has an empty cell, which is what allows it to be filled.
+ *
+ * @param shape The shape of the terrain.
+ * @param layout The layout written so far.
+ * @param axis The axis of the line.
+ * @param cell A cell on the line.
+ * @return true
+ * @return false
+ */
+template <typename Extent>
+bool
+is_line_free(const matrix::BasicShape<Extent>& shape, const Layout<Extent>& layout, const uint8_t axis, const matrix::Coordinates<Extent>& cell)
+{
+  for(const auto& line : layout.m_lines[axis])
+    {
+      if(on_line(axis, line, cell))
+        {
+          return false;
+        }
+    }
+
+  std::pmr::vector<Extent> occupied(layout.m_cells.get_allocator());
+
+  for(const auto& [written, value] : layout.m_cells)
+    {
+      if(on_line(axis, written, cell))
+        {
+          occupied.push_back(coordinate(axis, written));
+        }
+    }
 
-      search_direction(1, 0, 0, front);
-      search_direction(-1, 0, 0, front);
-      search_direction(0, 1, 0, front);
-      search_direction(0, -1, 0, front);
-      search_direction(0, 0, 1, front);
-      search_direction(0, 0, -1, front);
+  /** A crossing line occupies a single cell of the line */
+  for(uint8_t crossing_axis = 0; crossing_axis < 3; ++crossing_axis)
+    {
+      if(crossing_axis == axis)
+        {
+          continue;
+        }
+
+      const uint8_t shared_axis = 3 - axis - crossing_axis;
+
+      for(const auto& line : layout.m_lines[crossing_axis])
+        {
+          if(coordinate(shared_axis, line) == coordinate(shared_axis, cell))
+            {
+              occupied.push_back(coordinate(axis, line));
+            }
+        }
     }
 
-  return std::make_pair(graph, nodes);
+  std::sort(occupied.begin(), occupied.end());
+
+  const uint32_t extent[3] = { shape.m_x, shape.m_y, shape.m_z };
+  return std::unique(occupied.begin(), occupied.end()) - occupied.begin() < extent[axis];
 }
 
-matrix::Matrix
-mst_to_matrix(const matrix::Shape shape, const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<std::tuple<uint8_t, uint8_t, uint8_t>>& nodes)
+/**
+ * @brief Lays out the trace terrain of terminals following the same rules and order
+ * as the rasterization, without touching a matrix.
+ *
+ * @tparam Planar Whether the terrain is a single layer, its pillars are never free then.
+ * @param shape The shape of the terrain.
+ * @param terminals The terminals.
+ * @param memory The memory of the layout.
+ * @return Layout
+ */
+template <bool Planar, typename Extent>
+Layout<Extent>
+make_layout(const matrix::BasicShape<Extent>& shape, const std::vector<matrix::Coordinates<Extent>>& terminals, std::pmr::memory_resource* memory)
 {
-  matrix::Matrix matrix(shape);
+  Layout<Extent> layout(memory);
 
-  for(auto [first, second] : mst)
+  for(std::size_t i = 0, end = terminals.size(); i < end; ++i)
     {
-      auto [f_x, f_y, f_z] = nodes[first - 1];
-      auto [s_x, s_y, s_z] = nodes[second - 1];
+      const auto [c_x, c_y, c_z] = terminals[i];
+      const Access access          = access_of(shape, terminals, i);
+
+      layout.m_cells.emplace_back(terminals[i], types::TERMINAL_CELL);
+
+      if(access.m_is_x_blocked && access.m_is_y_blocked)
+        {
+          if(access.m_x_access_direction != 0)
+            {
+              layout.m_cells.emplace_back(std::make_tuple(Extent(c_x + access.m_x_access_direction), c_y, c_z), types::INTERSECTION_CELL);
+            }
+          else if(access.m_y_access_direction != 0)
+            {
+              layout.m_cells.emplace_back(std::make_tuple(c_x, Extent(c_y + access.m_y_access_direction), c_z), types::INTERSECTION_CELL);
+            }
+        }
+
+      if(!access.m_is_x_blocked && is_line_free(shape, layout, 0, terminals[i]))
+        {
+          layout.m_lines[0].push_back(terminals[i]);
+        }
 
-      if((s_x == f_x && s_y == f_y && s_z <= f_z) || (s_x == f_x && s_y <= f_y && s_z == f_z) || (s_x <= f_x && s_y == f_y && s_z == f_z))
+      if(!access.m_is_y_blocked && is_line_free(shape, layout, 1, terminals[i]))
         {
-          std::swap(f_x, s_x);
-          std::swap(f_y, s_y);
-          std::swap(f_z, s_z);
+          layout.m_lines[1].push_back(terminals[i]);
         }
 
-      if(f_x == s_x && f_y == s_y)
+      if constexpr(!Planar)
         {
-          for(; f_z <= s_z; ++f_z)
+          if(is_line_free(shape, layout, 2, terminals[i]))
             {
-              matrix.set_at(types::PATH_CELL, f_x, f_y, f_z);
+              layout.m_lines[2].push_back(terminals[i]);
             }
         }
-      else if(f_x == s_x)
+    }
+
+  return layout;
+}
+
+/**
+ * @brief Builds the ray masks of a layout.
+ *
+ * @param shape The shape of the terrain.
+ * @param layout The layout of the terrain.
+ * @return RayMasks
+ */
+template <bool Planar, typename Extent>
+RayMasks<Extent, Planar>
+make_masks(const matrix::BasicShape<Extent>& shape, const Layout<Extent>& layout)
+{
+  RayMasks<Extent, Planar> masks(shape, layout.m_cells.get_allocator().resource());
+
+  /** Every cell of a filled line is a trace cell unless something else is there too */
+  for(uint8_t axis = 0; axis < 3; ++axis)
+    {
+      const uint32_t extent[3] = { shape.m_x, shape.m_y, shape.m_z };
+
+      for(const auto& line : layout.m_lines[axis])
         {
-          for(; f_y <= s_y; ++f_y)
+          for(uint32_t i = 0; i < extent[axis]; ++i)
             {
-              matrix.set_at(types::PATH_CELL, f_x, f_y, f_z);
+              const auto [x, y, z] = with_coordinate<Extent>(axis, line, i);
+              masks.set_trace(x, y, z);
             }
         }
-      else if(f_y == s_y)
+    }
+
+  /** Cells covered by two lines become intersections */
+  for(uint8_t axis = 0; axis < 3; ++axis)
+    {
+      for(uint8_t crossing_axis = axis + 1; crossing_axis < 3; ++crossing_axis)
         {
-          for(; f_x <= s_x; ++f_x)
+          const uint8_t shared_axis = 3 - axis - crossing_axis;
+
+          for(const auto& line : layout.m_lines[axis])
             {
-              matrix.set_at(types::PATH_CELL, f_x, f_y, f_z);
+              for(const auto& crossing_line : layout.m_lines[crossing_axis])
+                {
+                  if(coordinate(shared_axis, line) == coordinate(shared_axis, crossing_line))
+                    {
+                      const auto [x, y, z] = with_coordinate(axis, line, coordinate(axis, crossing_line));
+                      masks.set_stop(x, y, z);
+                    }
+                }
             }
         }
     }
 
-  return matrix;
+  /** Written cells are terminals or intersections */
+  for(const auto& [cell, value] : layout.m_cells)
+    {
+      const auto [x, y, z] = cell;
+      masks.set_stop(x, y, z);
+    }
+
+  return masks;
+}
+
+/**
+ * @brief Layout mapped onto compressed coordinates. Only coordinates that hold written cells
+ * or lines are kept and every run of coordinates between them collapses into a single one.
+ *
+ */
+template <typename Extent>
+struct Compression
+{
+  explicit Compression(std::pmr::memory_resource* memory)
+      : m_layout(memory), m_coordinates{ Coordinates(memory), Coordinates(memory), Coordinates(memory) }
+  {
+  }
+
+  using Coordinates = std::pmr::vector<Extent>;
+
+  matrix::BasicShape<Extent> m_shape;          ///< Shape of the compressed terrain.
+  Layout<Extent>             m_layout;         ///< The layout in compressed coordinates.
+  Coordinates                m_coordinates[3]; ///< Original coordinate of every compressed one along each axis.
+};
+
+/**
+ * @brief Compresses the layout of a terrain. Cells between kept coordinates have the same
+ * class along the whole run, so rays over the compressed terrain hit the same nodes.
+ *
+ * @param layout The layout of the terrain.
+ * @return Compression
+ */
+template <typename Extent>
+Compression<Extent>
+compress(const Layout<Extent>& layout)
+{
+  std::pmr::memory_resource* memory = layout.m_cells.get_allocator().resource();
+  Compression<Extent>        compression(memory);
+
+  for(const auto& [cell, value] : layout.m_cells)
+    {
+      for(uint8_t axis = 0; axis < 3; ++axis)
+        {
+          compression.m_coordinates[axis].push_back(coordinate(axis, cell));
+        }
+    }
+
+  for(const auto& lines : layout.m_lines)
+    {
+      for(const auto& line : lines)
+        {
+          for(uint8_t axis = 0; axis < 3; ++axis)
+            {
+              compression.m_coordinates[axis].push_back(coordinate(axis, line));
+            }
+        }
+    }
+
+  for(auto& coordinates : compression.m_coordinates)
+    {
+      std::sort(coordinates.begin(), coordinates.end());
+      coordinates.erase(std::unique(coordinates.begin(), coordinates.end()), coordinates.end());
+
+      /** Keep one coordinate of every gap */
+      std::pmr::vector<Extent> kept(memory);
+
+      for(const Extent value : coordinates)
+        {
+          if(!kept.empty() && value > kept.back() + 1)
+            {
+              kept.push_back(kept.back() + 1);
+            }
+
+          kept.push_back(value);
+        }
+
+      coordinates = std::move(kept);
+    }
+
+  compression.m_shape = matrix::BasicShape<Extent>{ Extent(compression.m_coordinates[0].size()), Extent(compression.m_coordinates[1].size()), Extent(compression.m_coordinates[2].size()) };
+
+  auto encode         = [&](const matrix::Coordinates<Extent>& cell) {
+    matrix::Coordinates<Extent> encoded;
+
+    for(uint8_t axis = 0; axis < 3; ++axis)
+      {
+        const auto& coordinates = compression.m_coordinates[axis];
+        encoded                 = with_coordinate<Extent>(axis, encoded, std::lower_bound(coordinates.begin(), coordinates.end(), coordinate(axis, cell)) - coordinates.begin());
+      }
+
+    return encoded;
+  };
+
+  for(const auto& [cell, value] : layout.m_cells)
+    {
+      compression.m_layout.m_cells.emplace_back(encode(cell), value);
+    }
+
+  for(uint8_t axis = 0; axis < 3; ++axis)
+    {
+      for(const auto& line : layout.m_lines[axis])
+        {
+          compression.m_layout.m_lines[axis].push_back(encode(line));
+        }
+    }
+
+  return compression;
 }
 
+/**
+ * @brief Collects the trace graph reachable from the initial state by casting rays
+ * from every node. Rays along z are always cast, rays along x and y only if the
+ * layer of the node routes in that direction. Planar terrains cast no rays along z.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @tparam Planar Whether the terrain is a single layer.
+ * @tparam IsTerminal Callable that tells if a node is a terminal.
+ * @tparam Decode Callable that maps a node of the masks to the coordinates of the result.
+ * @param masks The ray masks of the terrain.
+ * @param inital_state The node to start from.
+ * @param layer_directions The directions of layers, repeated over the depth. Empty for all directions.
+ * @param is_terminal Terminal predicate.
+ * @param decode Coordinates mapping.
+ * @param graph The graph to write to, cleared first.
+ * @param nodes The coordinates of the nodes to write to, cleared first.
+ * @param memory The memory of the node map and the queue.
+ */
+template <typename Extent, bool Planar, typename IsTerminal, typename Decode>
+void
+trace_graph(const RayMasks<Extent, Planar>& masks, const matrix::Coordinates<Extent>& inital_state, const std::vector<uint8_t>& layer_directions, IsTerminal&& is_terminal, Decode&& decode, graph::Graph& graph, std::vector<matrix::Coordinates<Extent>>& nodes, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+{
+  std::pmr::unordered_map<matrix::Coordinates<Extent>, uint32_t, TupleHash>           node_map(memory);
+  std::queue<matrix::Coordinates<Extent>, std::pmr::deque<matrix::Coordinates<Extent>>> queue(memory);
+
+  graph.clear();
+  nodes.clear();
+
+  node_map[inital_state] = nodes.size();
+  nodes.emplace_back(decode(inital_state));
+
+  queue.push(inital_state);
+  graph.place_node();
+
+  auto search_direction = [&](const uint8_t axis, const int8_t direction, const matrix::Coordinates<Extent>& front) {
+    auto [x, y, z]    = front;
+
+    const int32_t hit = masks.cast(axis, direction, x, y, z);
+
+    if(hit < 0)
+      {
+        return;
+      }
+
+    const matrix::Coordinates<Extent> next_node = with_coordinate<Extent>(axis, front, hit);
+    uint32_t                                    dest_idx;
+
+    if(node_map.count(next_node) == 0)
+      {
+        node_map[next_node] = nodes.size();
+        dest_idx            = nodes.size();
+
+        nodes.push_back(decode(next_node));
+        queue.push(next_node);
+      }
+    else
+      {
+        dest_idx = node_map[next_node];
+      }
+
+    const uint32_t source_idx = node_map[front];
+    const uint32_t weight     = std::abs(int64_t(coordinate(axis, nodes[dest_idx])) - coordinate(axis, nodes[source_idx]));
+
+    graph.place_node();
+    graph.add_edge(weight, source_idx, dest_idx);
+
+    if(is_terminal(next_node))
+      {
+        graph.add_terminal(dest_idx);
+      }
+  };
+
+  while(!queue.empty())
+    {
+      const auto    front      = queue.front();
+      const Extent  layer      = std::get<2>(nodes[node_map[front]]);
+      const uint8_t directions = layer_directions.empty() ? types::ANY_DIRECTION_LAYER : layer_directions[layer % layer_directions.size()];
+
+      queue.pop();
+
+      if(directions & types::HORIZONTAL_LAYER)
+        {
+          search_direction(0, 1, front);
+          search_direction(0, -1, front);
+        }
+
+      if(directions & types::VERTICAL_LAYER)
+        {
+          search_direction(1, 1, front);
+          search_direction(1, -1, front);
+        }
+
+      if constexpr(!Planar)
+        {
+          search_direction(2, 1, front);
+          search_direction(2, -1, front);
+        }
+    }
+}
+
+/**
+ * @brief Returns the axis along which two cells of a segment differ, the depth one if
+ * they are the same cell.
+ *
+ */
+template <typename Extent>
+inline uint8_t
+axis_of(const matrix::Coordinates<Extent>& first, const matrix::Coordinates<Extent>& second)
+{
+  return std::get<0>(first) != std::get<0>(second) ? 0 : (std::get<1>(first) != std::get<1>(second) ? 1 : 2);
+}
+
+/**
+ * @brief Writes an axis-aligned segment into the matrix as path cells, ends included.
+ * Segments that are not axis-aligned are skipped.
+ *
+ * @param matrix The matrix to write to.
+ * @param first The first end of the segment.
+ * @param second The second end of the segment.
+ */
+template <typename Extent>
+void
+fill_segment(matrix::BasicMatrix<Extent>& matrix, const matrix::Coordinates<Extent>& first, const matrix::Coordinates<Extent>& second)
+{
+  const matrix::BasicShape<Extent>& shape    = matrix.shape();
+
+  /** Strides of the matrix layout, depth is the innermost axis and is stored reversed */
+  const std::size_t                 x_stride = shape.m_z;
+  const std::size_t                 y_stride = std::size_t(shape.m_y) * shape.m_z;
+
+  const auto [f_x, f_y, f_z]                 = first;
+  const auto [s_x, s_y, s_z]                 = second;
+
+  const Extent min_x                         = std::min(f_x, s_x);
+  const Extent min_y                         = std::min(f_y, s_y);
+  const Extent max_z                         = std::max(f_z, s_z);
+
+  uint8_t*     begin                         = matrix.data() + min_y * y_stride + min_x * x_stride + (shape.m_z - max_z - 1);
+
+  if(f_x == s_x && f_y == s_y)
+    {
+      std::memset(begin, types::PATH_CELL, max_z - std::min(f_z, s_z) + 1);
+    }
+  else if(f_x == s_x && f_z == s_z)
+    {
+      for(std::size_t i = 0, length = std::max(f_y, s_y) - min_y + 1; i < length; ++i)
+        {
+          begin[i * y_stride] = types::PATH_CELL;
+        }
+    }
+  else if(f_y == s_y && f_z == s_z)
+    {
+      const std::size_t length = std::max(f_x, s_x) - min_x + 1;
+
+      if(x_stride == 1)
+        {
+          std::memset(begin, types::PATH_CELL, length);
+        }
+      else
+        {
+          for(std::size_t i = 0; i < length; ++i)
+            {
+              begin[i * x_stride] = types::PATH_CELL;
+            }
+        }
+    }
+}
+
+} // namespace details
+
+template <typename Extent>
+matrix::Coordinates<Extent>
+index_to_coordinates(uint64_t index, std::type_identity_t<Extent> size)
+{
+  const uint64_t layer_size = uint64_t(size) * size;
+  const uint64_t remainder  = index % layer_size;
+
+  const Extent   x          = remainder / size;
+  const Extent   y          = remainder % size;
+  const Extent   z          = index / layer_size;
+
+  return { x, y, z };
+}
+
+template <typename Extent>
+std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>>
+matrix_to_graph(const matrix::BasicMatrix<Extent>& matrix, const matrix::Coordinates<Extent>& inital_state, const std::vector<uint8_t>& layer_directions)
+{
+  const auto                                                        view = matrix.view();
+
+  std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>> result;
+
+  details::with_depth_class(matrix.shape(), [&](const auto planar) {
+    details::trace_graph(
+        details::RayMasks<Extent, planar>(matrix), inital_state, layer_directions,
+        [&](const matrix::Coordinates<Extent>& node) {
+          return view(std::get<0>(node), std::get<1>(node), std::get<2>(node)) == types::TERMINAL_CELL;
+        },
+        [](const matrix::Coordinates<Extent>& node) { return node; }, result.first, result.second);
+  });
+
+  return result;
+}
+
+template <typename Extent>
+matrix::BasicBitPlaneMatrix<Extent>
+terminals_to_bit_planes(const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals)
+{
+  matrix::BasicBitPlaneMatrix<Extent> planes(shape);
+
+  for(std::size_t i = 0, end = terminals.size(); i < end; ++i)
+    {
+      const auto [c_x, c_y, c_z]   = terminals[i];
+      const details::Access access = details::access_of(shape, terminals, i);
+
+      planes.set_at(types::TERMINAL_CELL, c_x, c_y, c_z);
+
+      if(access.m_is_x_blocked && access.m_is_y_blocked)
+        {
+          if(access.m_x_access_direction != 0)
+            {
+              planes.set_at(types::INTERSECTION_CELL, c_x + access.m_x_access_direction, c_y, c_z);
+            }
+          else if(access.m_y_access_direction != 0)
+            {
+              planes.set_at(types::INTERSECTION_CELL, c_x, c_y + access.m_y_access_direction, c_z);
+            }
+        }
+
+      if(!access.m_is_x_blocked)
+        {
+          planes.fill_row(c_y, c_z, types::INTERSECTION_CELL);
+        }
+
+      if(!access.m_is_y_blocked)
+        {
+          planes.fill_column(c_x, c_z, types::INTERSECTION_CELL);
+        }
+
+      planes.fill_pillar(c_x, c_y, types::INTERSECTION_VIA_CELL);
+    }
+
+  return planes;
+}
+
+template <typename Extent>
+matrix::BasicMatrix<Extent>
+terminals_to_matrix(const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals)
+{
+  matrix::BasicMatrix<Extent> source_matrix(shape);
+  terminals_to_matrix(source_matrix, terminals);
+
+  return source_matrix;
+}
+
+template <typename Extent>
+void
+terminals_to_matrix(matrix::BasicMatrix<Extent>& source_matrix, const std::vector<matrix::Coordinates<Extent>>& terminals)
+{
+  const matrix::BasicShape<Extent>& shape = source_matrix.shape();
+  const auto                        view  = source_matrix.view();
+
+  source_matrix.fill(0);
+
+  for(std::size_t i = 0, end = terminals.size(); i < end; ++i)
+    {
+      const auto [c_x, c_y, c_z]   = terminals[i];
+      const details::Access access = details::access_of(shape, terminals, i);
+
+      view(c_x, c_y, c_z)          = types::TERMINAL_CELL;
+
+      if(access.m_is_x_blocked && access.m_is_y_blocked)
+        {
+          if(access.m_x_access_direction != 0)
+            {
+              view(c_x + access.m_x_access_direction, c_y, c_z) = types::INTERSECTION_CELL;
+            }
+          else if(access.m_y_access_direction != 0)
+            {
+              view(c_x, c_y + access.m_y_access_direction, c_z) = types::INTERSECTION_CELL;
+            }
+        }
+
+      if(!access.m_is_x_blocked)
+        {
+          details::fill_line(view.row(c_y, c_z), types::INTERSECTION_CELL);
+        }
+
+      if(!access.m_is_y_blocked)
+        {
+          details::fill_line(view.column(c_x, c_z), types::INTERSECTION_CELL);
+        }
+
+      /** A pillar of a single layer holds just the terminal */
+      if(shape.m_z > 1)
+        {
+          details::fill_line(view.pillar(c_x, c_y), types::INTERSECTION_VIA_CELL);
+        }
+    }
+}
+
+template <typename Extent>
+void
+terminals_to_features(std::vector<uint16_t>& features, const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals)
+{
+  /** Strides of the matrix layout, depth is the innermost axis and is stored reversed */
+  const std::size_t x_stride = shape.m_z;
+  const std::size_t y_stride = std::size_t(shape.m_y) * shape.m_z;
+  const std::size_t cells    = std::size_t(shape.m_x) * shape.m_y * shape.m_z;
+
+  features.resize(2 * cells);
+
+  if(cells == 0)
+    {
+      return;
+    }
+
+  uint16_t* distance = features.data();
+  uint16_t* box      = distance + cells;
+
+  /** Saturated step of the distance, so that unreached cells stay unreached */
+  auto      step     = [](const uint16_t value) { return uint16_t(value + (value < UINT16_MAX)); };
+
+  std::fill(distance, distance + cells, UINT16_MAX);
+  std::fill(box, box + cells, 0);
+
+  for(const auto& [x, y, z] : terminals)
+    {
+      distance[y * y_stride + x * x_stride + (shape.m_z - z - 1)] = 0;
+    }
+
+  /** Manhattan distance is separable, a forward and a backward pass along each axis make it exact */
+  auto sweep = [](uint16_t* line, const std::size_t length) {
+    /** The running distance is kept wider so that the chain does not need to saturate */
+    uint32_t running = UINT16_MAX;
+
+    for(std::size_t i = 0; i < length; ++i)
+      {
+        running = line[i] = uint16_t(std::min<uint32_t>(line[i], running + 1));
+      }
+
+    running = UINT16_MAX;
+
+    for(std::size_t i = length; i-- > 0;)
+      {
+        running = line[i] = uint16_t(std::min<uint32_t>(line[i], running + 1));
+      }
+  };
+
+  /** Lines that are not contiguous are relaxed a whole block of them at a time, the inner loops vectorize */
+  auto relax = [&](uint16_t* first, const std::size_t stride, const std::size_t length, const std::size_t width) {
+    for(std::size_t i = 1; i < length; ++i)
+      {
+        uint16_t*       current  = first + i * stride;
+        const uint16_t* previous = current - stride;
+
+        for(std::size_t k = 0; k < width; ++k)
+          {
+            current[k] = std::min(current[k], step(previous[k]));
+          }
+      }
+
+    for(std::size_t i = length - 1; i > 0; --i)
+      {
+        uint16_t*       current = first + (i - 1) * stride;
+        const uint16_t* next    = current + stride;
+
+        for(std::size_t k = 0; k < width; ++k)
+          {
+            current[k] = std::min(current[k], step(next[k]));
+          }
+      }
+  };
+
+  /** Before the last pass only the pillars and planes holding a terminal are reached, the others are skipped */
+  std::vector<std::size_t> pillars;
+  std::vector<std::size_t> planes;
+
+  for(const auto& [x, y, z] : terminals)
+    {
+      pillars.push_back(y * y_stride + x * x_stride);
+      planes.push_back(y * y_stride);
+    }
+
+  for(auto* offsets : { &pillars, &planes })
+    {
+      std::sort(offsets->begin(), offsets->end());
+      offsets->erase(std::unique(offsets->begin(), offsets->end()), offsets->end());
+    }
+
+  if(shape.m_z > 1)
+    {
+      for(const std::size_t pillar : pillars)
+        {
+          sweep(distance + pillar, shape.m_z);
+        }
+
+      for(const std::size_t plane : planes)
+        {
+          relax(distance + plane, x_stride, shape.m_x, x_stride);
+        }
+    }
+  else
+    {
+      /** Rows of a single layer are contiguous */
+      for(const std::size_t plane : planes)
+        {
+          sweep(distance + plane, shape.m_x);
+        }
+    }
+
+  relax(distance, y_stride, shape.m_y, std::size_t(shape.m_x) * x_stride);
+
+  if(terminals.empty())
+    {
+      return;
+    }
+
+  auto [min_x, min_y, min_z] = terminals.front();
+  auto [max_x, max_y, max_z] = terminals.front();
+
+  for(const auto& [x, y, z] : terminals)
+    {
+      min_x = std::min(min_x, x);
+      min_y = std::min(min_y, y);
+      min_z = std::min(min_z, z);
+      max_x = std::max(max_x, x);
+      max_y = std::max(max_y, y);
+      max_z = std::max(max_z, z);
+    }
+
+  /** The first row of the box is filled pillar by pillar, the other rows are copies of it */
+  uint16_t* const row     = box + min_y * y_stride;
+  uint16_t* const row_end = row + (max_x + 1) * x_stride;
+
+  for(std::size_t x = min_x; x <= max_x; ++x)
+    {
+      uint16_t* pillar = row + x * x_stride;
+      std::fill(pillar + (shape.m_z - max_z - 1), pillar + (shape.m_z - min_z), 1);
+    }
+
+  for(std::size_t y = min_y + 1; y <= max_y; ++y)
+    {
+      std::copy(row + min_x * x_stride, row_end, box + y * y_stride + min_x * x_stride);
+    }
+}
+
+template <typename Extent>
+std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>>
+terminals_to_graph(const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals, const std::vector<uint8_t>& layer_directions)
+{
+  std::pair<graph::Graph, std::vector<matrix::Coordinates<Extent>>> result;
+  terminals_to_graph(result.first, result.second, shape, terminals, layer_directions);
+
+  return result;
+}
+
+template <typename Extent>
+void
+terminals_to_graph(graph::Graph& graph, std::vector<matrix::Coordinates<Extent>>& nodes, const matrix::BasicShape<Extent> shape, const std::vector<matrix::Coordinates<Extent>>& terminals, const std::vector<uint8_t>& layer_directions, std::pmr::memory_resource* memory)
+{
+  details::with_depth_class(shape, [&](const auto planar) {
+    /** Solve on the compressed terrain, the nodes and weights are mapped back to the original coordinates */
+    const details::Compression<Extent>      compression = details::compress(details::make_layout<planar>(shape, terminals, memory));
+    const details::RayMasks<Extent, planar> masks       = details::make_masks<planar>(compression.m_shape, compression.m_layout);
+
+    /** Written cells are terminals or intersections, whichever was written last */
+    std::pmr::unordered_map<matrix::Coordinates<Extent>, uint8_t, details::TupleHash> cells(memory);
+
+    for(const auto& [cell, value] : compression.m_layout.m_cells)
+      {
+        cells[cell] = value;
+      }
+
+    /** The first written cell is the first terminal */
+    details::trace_graph(
+        masks, compression.m_layout.m_cells.front().first, layer_directions,
+        [&](const matrix::Coordinates<Extent>& node) {
+          const auto it = cells.find(node);
+          return it != cells.end() && it->second == types::TERMINAL_CELL;
+        },
+        [&](const matrix::Coordinates<Extent>& node) {
+          return std::make_tuple(compression.m_coordinates[0][std::get<0>(node)], compression.m_coordinates[1][std::get<1>(node)], compression.m_coordinates[2][std::get<2>(node)]);
+        },
+        graph, nodes, memory);
+  });
+}
+
+template <typename Extent>
+void
+mst_to_matrix(matrix::BasicMatrix<Extent>& matrix, const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<matrix::Coordinates<Extent>>& nodes)
+{
+  matrix.fill(0);
+
+  for(const auto& [first, second] : mst)
+    {
+      details::fill_segment(matrix, nodes[first - 1], nodes[second - 1]);
+    }
+}
+
+template <typename Extent>
+matrix::BasicMatrix<Extent>
+mst_to_matrix(const matrix::BasicShape<Extent> shape, const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<matrix::Coordinates<Extent>>& nodes)
+{
+  matrix::BasicMatrix<Extent> matrix(shape);
+  mst_to_matrix(matrix, mst, nodes);
+
+  return matrix;
+}
+
+template <typename Extent>
+SparseTree<Extent>
+mst_to_sparse(const std::vector<std::pair<uint32_t, uint32_t>>& mst, const std::vector<matrix::Coordinates<Extent>>& nodes)
+{
+  std::vector<std::vector<uint32_t>> adj(nodes.size() + 1);
+
+  for(const auto& [first, second] : mst)
+    {
+      adj[first].push_back(second);
+      adj[second].push_back(first);
+    }
+
+  /** A node is kept if the tree branches, ends or bends in it */
+  auto is_point = [&](const uint32_t node) {
+    const auto& neighbours = adj[node];
+
+    return neighbours.size() != 2 || details::axis_of(nodes[neighbours[0] - 1], nodes[node - 1]) != details::axis_of(nodes[node - 1], nodes[neighbours[1] - 1]);
+  };
+
+  SparseTree<Extent>    tree;
+  std::vector<uint32_t> point_of(nodes.size() + 1, UINT32_MAX);
+
+  for(uint32_t node = 1; node <= nodes.size(); ++node)
+    {
+      if(!adj[node].empty() && is_point(node))
+        {
+          const auto [x, y, z] = nodes[node - 1];
+
+          point_of[node]       = static_cast<uint32_t>(tree.m_points.size() / 3);
+
+          tree.m_points.push_back(x);
+          tree.m_points.push_back(y);
+          tree.m_points.push_back(z);
+        }
+    }
+
+  /** Walk every straight run from a kept node to the next one, each run is found from both of its ends */
+  for(uint32_t node = 1; node <= nodes.size(); ++node)
+    {
+      if(point_of[node] == UINT32_MAX)
+        {
+          continue;
+        }
+
+      for(const uint32_t neighbour : adj[node])
+        {
+          uint32_t previous = node;
+          uint32_t current  = neighbour;
+
+          while(point_of[current] == UINT32_MAX)
+            {
+              const uint32_t next = adj[current][0] == previous ? adj[current][1] : adj[current][0];
+
+              previous            = current;
+              current             = next;
+            }
+
+          if(node < current)
+            {
+              tree.m_segments.push_back(point_of[node]);
+              tree.m_segments.push_back(point_of[current]);
+            }
+        }
+    }
+
+  return tree;
+}
+
+template <typename Extent>
+void
+sparse_to_matrix(matrix::BasicMatrix<Extent>& matrix, const SparseTree<Extent>& tree)
+{
+  const auto point = [&](const uint32_t i) {
+    return matrix::Coordinates<Extent>(tree.m_points[i * 3], tree.m_points[i * 3 + 1], tree.m_points[i * 3 + 2]);
+  };
+
+  matrix.fill(0);
+
+  for(std::size_t i = 0; i + 1 < tree.m_segments.size(); i += 2)
+    {
+      details::fill_segment(matrix, point(tree.m_segments[i]), point(tree.m_segments[i + 1]));
+    }
+}
+
+template <typename Extent>
+CsrGraph<Extent>
+graph_to_csr(const graph::Graph& graph, const std::vector<matrix::Coordinates<Extent>>& nodes, const std::vector<std::pair<uint32_t, uint32_t>>& mst)
+{
+  const auto&                  adj       = graph.get_adj();
+  const auto&                  terminals = graph.get_terminals();
+
+  std::unordered_set<uint64_t> solution;
+
+  for(const auto& [source, destination] : mst)
+    {
+      const uint64_t low  = std::min(source, destination);
+      const uint64_t high = std::max(source, destination);
+
+      solution.insert(low << 32 | high);
+    }
+
+  CsrGraph<Extent> csr;
+
+  csr.m_features.reserve(nodes.size() * 4);
+  csr.m_indptr.reserve(nodes.size() + 1);
+  csr.m_indptr.push_back(0);
+
+  for(std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto [x, y, z] = nodes[i];
+
+      csr.m_features.push_back(x);
+      csr.m_features.push_back(y);
+      csr.m_features.push_back(z);
+      csr.m_features.push_back(terminals.contains(i + 1) ? 1 : 0);
+
+      if(i < adj.size())
+        {
+          for(const auto& edge : adj[i])
+            {
+              const uint64_t low  = std::min(edge.m_source, edge.m_destination);
+              const uint64_t high = std::max(edge.m_source, edge.m_destination);
+
+              csr.m_indices.push_back(edge.m_destination - 1);
+              csr.m_weights.push_back(edge.m_weight);
+              csr.m_labels.push_back(solution.contains(low << 32 | high) ? 1 : 0);
+            }
+        }
+
+      csr.m_indptr.push_back(static_cast<uint32_t>(csr.m_indices.size()));
+    }
+
+  return csr;
+}
+
+/** =============================== INSTANTIATIONS =============================== */
+
+template matrix::Coordinates<uint8_t> index_to_coordinates<uint8_t>(uint64_t, uint8_t);
+template std::pair<graph::Graph, std::vector<matrix::Coordinates<uint8_t>>> matrix_to_graph<uint8_t>(const matrix::BasicMatrix<uint8_t>&, const matrix::Coordinates<uint8_t>&, const std::vector<uint8_t>&);
+template matrix::BasicMatrix<uint8_t> terminals_to_matrix<uint8_t>(const matrix::BasicShape<uint8_t>, const std::vector<matrix::Coordinates<uint8_t>>&);
+template matrix::BasicBitPlaneMatrix<uint8_t> terminals_to_bit_planes<uint8_t>(const matrix::BasicShape<uint8_t>, const std::vector<matrix::Coordinates<uint8_t>>&);
+template std::pair<graph::Graph, std::vector<matrix::Coordinates<uint8_t>>> terminals_to_graph<uint8_t>(const matrix::BasicShape<uint8_t>, const std::vector<matrix::Coordinates<uint8_t>>&, const std::vector<uint8_t>&);
+template void terminals_to_matrix<uint8_t>(matrix::BasicMatrix<uint8_t>&, const std::vector<matrix::Coordinates<uint8_t>>&);
+template void terminals_to_features<uint8_t>(std::vector<uint16_t>&, const matrix::BasicShape<uint8_t>, const std::vector<matrix::Coordinates<uint8_t>>&);
+template void terminals_to_graph<uint8_t>(graph::Graph&, std::vector<matrix::Coordinates<uint8_t>>&, const matrix::BasicShape<uint8_t>, const std::vector<matrix::Coordinates<uint8_t>>&, const std::vector<uint8_t>&, std::pmr::memory_resource*);
+template void mst_to_matrix<uint8_t>(matrix::BasicMatrix<uint8_t>&, const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint8_t>>&);
+template matrix::BasicMatrix<uint8_t> mst_to_matrix<uint8_t>(const matrix::BasicShape<uint8_t>, const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint8_t>>&);
+template SparseTree<uint8_t> mst_to_sparse<uint8_t>(const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint8_t>>&);
+template void sparse_to_matrix<uint8_t>(matrix::BasicMatrix<uint8_t>&, const SparseTree<uint8_t>&);
+template CsrGraph<uint8_t> graph_to_csr<uint8_t>(const graph::Graph&, const std::vector<matrix::Coordinates<uint8_t>>&, const std::vector<std::pair<uint32_t, uint32_t>>&);
+
+template matrix::Coordinates<uint16_t> index_to_coordinates<uint16_t>(uint64_t, uint16_t);
+template std::pair<graph::Graph, std::vector<matrix::Coordinates<uint16_t>>> matrix_to_graph<uint16_t>(const matrix::BasicMatrix<uint16_t>&, const matrix::Coordinates<uint16_t>&, const std::vector<uint8_t>&);
+template matrix::BasicMatrix<uint16_t> terminals_to_matrix<uint16_t>(const matrix::BasicShape<uint16_t>, const std::vector<matrix::Coordinates<uint16_t>>&);
+template matrix::BasicBitPlaneMatrix<uint16_t> terminals_to_bit_planes<uint16_t>(const matrix::BasicShape<uint16_t>, const std::vector<matrix::Coordinates<uint16_t>>&);
+template std::pair<graph::Graph, std::vector<matrix::Coordinates<uint16_t>>> terminals_to_graph<uint16_t>(const matrix::BasicShape<uint16_t>, const std::vector<matrix::Coordinates<uint16_t>>&, const std::vector<uint8_t>&);
+template void terminals_to_matrix<uint16_t>(matrix::BasicMatrix<uint16_t>&, const std::vector<matrix::Coordinates<uint16_t>>&);
+template void terminals_to_features<uint16_t>(std::vector<uint16_t>&, const matrix::BasicShape<uint16_t>, const std::vector<matrix::Coordinates<uint16_t>>&);
+template void terminals_to_graph<uint16_t>(graph::Graph&, std::vector<matrix::Coordinates<uint16_t>>&, const matrix::BasicShape<uint16_t>, const std::vector<matrix::Coordinates<uint16_t>>&, const std::vector<uint8_t>&, std::pmr::memory_resource*);
+template void mst_to_matrix<uint16_t>(matrix::BasicMatrix<uint16_t>&, const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint16_t>>&);
+template matrix::BasicMatrix<uint16_t> mst_to_matrix<uint16_t>(const matrix::BasicShape<uint16_t>, const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint16_t>>&);
+template SparseTree<uint16_t> mst_to_sparse<uint16_t>(const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint16_t>>&);
+template void sparse_to_matrix<uint16_t>(matrix::BasicMatrix<uint16_t>&, const SparseTree<uint16_t>&);
+template CsrGraph<uint16_t> graph_to_csr<uint16_t>(const graph::Graph&, const std::vector<matrix::Coordinates<uint16_t>>&, const std::vector<std::pair<uint32_t, uint32_t>>&);
+
+template matrix::Coordinates<uint32_t> index_to_coordinates<uint32_t>(uint64_t, uint32_t);
+template std::pair<graph::Graph, std::vector<matrix::Coordinates<uint32_t>>> matrix_to_graph<uint32_t>(const matrix::BasicMatrix<uint32_t>&, const matrix::Coordinates<uint32_t>&, const std::vector<uint8_t>&);
+template matrix::BasicMatrix<uint32_t> terminals_to_matrix<uint32_t>(const matrix::BasicShape<uint32_t>, const std::vector<matrix::Coordinates<uint32_t>>&);
+template matrix::BasicBitPlaneMatrix<uint32_t> terminals_to_bit_planes<uint32_t>(const matrix::BasicShape<uint32_t>, const std::vector<matrix::Coordinates<uint32_t>>&);
+template std::pair<graph::Graph, std::vector<matrix::Coordinates<uint32_t>>> terminals_to_graph<uint32_t>(const matrix::BasicShape<uint32_t>, const std::vector<matrix::Coordinates<uint32_t>>&, const std::vector<uint8_t>&);
+template void terminals_to_matrix<uint32_t>(matrix::BasicMatrix<uint32_t>&, const std::vector<matrix::Coordinates<uint32_t>>&);
+template void terminals_to_features<uint32_t>(std::vector<uint16_t>&, const matrix::BasicShape<uint32_t>, const std::vector<matrix::Coordinates<uint32_t>>&);
+template void terminals_to_graph<uint32_t>(graph::Graph&, std::vector<matrix::Coordinates<uint32_t>>&, const matrix::BasicShape<uint32_t>, const std::vector<matrix::Coordinates<uint32_t>>&, const std::vector<uint8_t>&, std::pmr::memory_resource*);
+template void mst_to_matrix<uint32_t>(matrix::BasicMatrix<uint32_t>&, const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint32_t>>&);
+template matrix::BasicMatrix<uint32_t> mst_to_matrix<uint32_t>(const matrix::BasicShape<uint32_t>, const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint32_t>>&);
+template SparseTree<uint32_t> mst_to_sparse<uint32_t>(const std::vector<std::pair<uint32_t, uint32_t>>&, const std::vector<matrix::Coordinates<uint32_t>>&);
+template void sparse_to_matrix<uint32_t>(matrix::BasicMatrix<uint32_t>&, const SparseTree<uint32_t>&);
+template CsrGraph<uint32_t> graph_to_csr<uint32_t>(const graph::Graph&, const std::vector<matrix::Coordinates<uint32_t>>&, const std::vector<std::pair<uint32_t, uint32_t>>&);
+
 } // namespace transform
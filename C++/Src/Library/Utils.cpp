@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <cmath>
 #include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <thread>
+#include <utility>
+
+#include <sched.h>
 
 #include "Include/Utilis.hpp"
 
@@ -66,4 +72,283 @@ SyncProgressBar::step()
     }
 }
 
+/** =============================== CPUS ========================================= */
+
+namespace details
+{
+
+/**
+ * @brief Returns the CPU quota of the cgroup, 0 if there is none. Version 2 keeps the
+ * quota and the period in cpu.max, version 1 in two files.
+ *
+ * @return double
+ */
+double
+cgroup_quota()
+{
+  if(std::ifstream file("/sys/fs/cgroup/cpu.max"); file)
+    {
+      std::string quota;
+      double      period = 0;
+
+      if(file >> quota >> period && quota != "max" && period > 0)
+        {
+          return std::stod(quota) / period;
+        }
+
+      return 0;
+    }
+
+  std::ifstream quota_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+  std::ifstream period_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+  double        quota  = 0;
+  double        period = 0;
+
+  if(quota_file >> quota && period_file >> period && quota > 0 && period > 0)
+    {
+      return quota / period;
+    }
+
+  return 0;
+}
+
+} // namespace details
+
+std::size_t
+available_cpus()
+{
+  std::size_t cpus = std::thread::hardware_concurrency();
+
+  if(cpu_set_t set; sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+      cpus = cpus == 0 ? CPU_COUNT(&set) : std::min<std::size_t>(cpus, CPU_COUNT(&set));
+    }
+
+  /** A fractional quota still keeps a CPU partly busy */
+  if(const double quota = details::cgroup_quota(); quota > 0)
+    {
+      cpus = std::min<std::size_t>(cpus, std::ceil(quota));
+    }
+
+  return std::max<std::size_t>(cpus, 1);
+}
+
+/** =============================== TASK POOL ==================================== */
+
+TaskPool::TaskPool(const std::size_t number_of_workers)
+{
+  const std::size_t workers = std::max<std::size_t>(number_of_workers, 1);
+
+  for(std::size_t i = 0; i < workers; ++i)
+    {
+      m_queues.push_back(std::make_unique<Queue>());
+    }
+
+  for(std::size_t i = 0; i < workers; ++i)
+    {
+      m_threads.emplace_back(&TaskPool::work, this, i);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_queued_condition.notify_all();
+
+  for(auto& thread : m_threads)
+    {
+      thread.join();
+    }
+}
+
+std::size_t
+TaskPool::size() const
+{
+  return m_threads.size();
+}
+
+void
+TaskPool::submit(Task task)
+{
+  Queue&          queue = *m_queues[m_next.fetch_add(1) % m_queues.size()];
+  std::lock_guard queue_lock(queue.m_mutex);
+
+  queue.m_tasks.push_back(std::move(task));
+
+  /** Counted while the deque is still locked, so that no worker takes the task before */
+  {
+    std::lock_guard lock(m_mutex);
+    ++m_queued;
+    ++m_pending;
+  }
+
+  m_queued_condition.notify_one();
+}
+
+void
+TaskPool::wait()
+{
+  std::unique_lock lock(m_mutex);
+  m_done_condition.wait(lock, [this]() { return m_pending == 0; });
+
+  if(m_error)
+    {
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+}
+
+void
+TaskPool::for_each(const std::size_t worker, const std::size_t count, const Job& job)
+{
+  /** Shared with the helper tasks, which may only start once all jobs are taken */
+  struct Group
+  {
+    const Job*               m_job   = nullptr;
+    std::size_t              m_count = 0;
+    std::atomic<std::size_t> m_next  = 0;
+    std::size_t              m_done  = 0;
+    std::mutex               m_mutex;
+    std::condition_variable  m_done_condition;
+    std::exception_ptr       m_error;
+  };
+
+  const auto group = std::make_shared<Group>();
+  group->m_job     = &job;
+  group->m_count   = count;
+
+  const auto run   = [](Group& group, const std::size_t worker) {
+    for(std::size_t i; (i = group.m_next.fetch_add(1)) < group.m_count;)
+      {
+        std::exception_ptr error;
+
+        try
+          {
+            (*group.m_job)(i, worker);
+          }
+        catch(...)
+          {
+            error = std::current_exception();
+          }
+
+        std::lock_guard lock(group.m_mutex);
+
+        if(error && !group.m_error)
+          {
+            group.m_error = error;
+          }
+
+        if(++group.m_done == group.m_count)
+          {
+            group.m_done_condition.notify_all();
+          }
+      }
+  };
+
+  for(std::size_t i = 1, end = std::min(size(), count); i < end; ++i)
+    {
+      submit([group, run](const std::size_t helper) { run(*group, helper); });
+    }
+
+  run(*group, worker);
+
+  /** Only jobs already running on other workers are left */
+  std::unique_lock lock(group->m_mutex);
+  group->m_done_condition.wait(lock, [&group]() { return group->m_done == group->m_count; });
+
+  if(group->m_error)
+    {
+      std::rethrow_exception(group->m_error);
+    }
+}
+
+void
+TaskPool::work(const std::size_t worker)
+{
+  Task task;
+
+  while(true)
+    {
+      if(take(worker, task))
+        {
+          std::exception_ptr error;
+
+          try
+            {
+              task(worker);
+            }
+          catch(...)
+            {
+              error = std::current_exception();
+            }
+
+          task = nullptr;
+
+          std::lock_guard lock(m_mutex);
+
+          if(error && !m_error)
+            {
+              m_error = error;
+            }
+
+          if(--m_pending == 0)
+            {
+              m_done_condition.notify_all();
+            }
+
+          continue;
+        }
+
+      std::unique_lock lock(m_mutex);
+      m_queued_condition.wait(lock, [this]() { return m_stop || m_queued > 0; });
+
+      if(m_stop && m_queued == 0)
+        {
+          return;
+        }
+    }
+}
+
+bool
+TaskPool::take(const std::size_t worker, Task& task)
+{
+  const std::size_t workers = m_queues.size();
+
+  /** Own tasks from the front, stolen ones from the back */
+  for(std::size_t i = 0; i < workers; ++i)
+    {
+      Queue&          queue = *m_queues[(worker + i) % workers];
+      std::lock_guard lock(queue.m_mutex);
+
+      if(!queue.m_tasks.empty())
+        {
+          if(i == 0)
+            {
+              task = std::move(queue.m_tasks.front());
+              queue.m_tasks.pop_front();
+            }
+          else
+            {
+              task = std::move(queue.m_tasks.back());
+              queue.m_tasks.pop_back();
+            }
+
+          break;
+        }
+    }
+
+  if(!task)
+    {
+      return false;
+    }
+
+  std::lock_guard lock(m_mutex);
+  --m_queued;
+
+  return true;
+}
+
 } // namespace utils
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+
+#include "Include/Algorithms.hpp"
+#include "Include/Types.hpp"
+#include "Include/Transform.hpp"
+
+namespace
+{
+
+/**
+ * @brief Checks that the edges form a tree over graph edges that connects all terminals
+ * and has only terminals as leaves.
+ *
+ * @param graph The graph.
+ * @param mst The edges of the tree.
+ */
+void
+expect_steiner_tree(const graph::Graph& graph, const std::vector<std::pair<uint32_t, uint32_t>>& mst)
+{
+  const auto&                  adj = graph.get_adj();
+
+  std::map<uint32_t, uint32_t> degrees;
+  std::map<uint32_t, uint32_t> parent;
+
+  auto                         find = [&](uint32_t node) {
+    while(parent.count(node) != 0 && parent[node] != node)
+      {
+        node = parent[node];
+      }
+
+    return node;
+  };
+
+  for(const auto& [source, destination] : mst)
+    {
+      const auto& connections = adj[source - 1];
+
+      EXPECT_NE(std::find_if(connections.begin(), connections.end(), [destination](const graph::Edge& edge) { return edge.m_destination == destination; }), connections.end());
+
+      /** No cycles */
+      ASSERT_NE(find(source), find(destination));
+      parent[find(source)] = find(destination);
+
+      ++degrees[source];
+      ++degrees[destination];
+    }
+
+  for(const auto& [node, degree] : degrees)
+    {
+      if(degree == 1)
+        {
+          EXPECT_EQ(graph.get_terminals().count(node), 1);
+        }
+    }
+
+  const uint32_t root = find(*graph.get_terminals().begin());
+
+  for(const uint32_t terminal : graph.get_terminals())
+    {
+      EXPECT_EQ(find(terminal), root);
+    }
+}
+
+} // namespace
+
+TEST(AlgorithmsTest, DijkstraKruskalGreedy)
+{
+  std::mt19937 random(7);
+
+  for(std::size_t i = 0; i < 40; ++i)
+    {
+      std::set<uint32_t> indices;
+
+      while(indices.size() < 5)
+        {
+          indices.insert(random() % (32 * 32));
+        }
+
+      std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> terminals;
+
+      for(const auto index : indices)
+        {
+          terminals.push_back(transform::index_to_coordinates(index, 32));
+        }
+
+      const auto [graph, nodes] = transform::terminals_to_graph({ 32, 32, 1 }, terminals);
+
+      expect_steiner_tree(graph, algorithms::dijkstra_kruskal_greedy(graph));
+    }
+}
+
+TEST(AlgorithmsTest, WorkspaceReuse)
+{
+  std::mt19937                                       random(5);
+
+  algorithms::Workspace                              workspace;
+  graph::Graph                                       graph;
+  std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> nodes;
+
+  /** Graphs of varying size go through the same buffers */
+  for(std::size_t i = 0; i < 40; ++i)
+    {
+      std::set<uint32_t> indices;
+
+      while(indices.size() < 2 + i % 5)
+        {
+          indices.insert(random() % (16 * 16 * 2));
+        }
+
+      std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> terminals;
+
+      for(const auto index : indices)
+        {
+          terminals.push_back(transform::index_to_coordinates(index, 16));
+        }
+
+      transform::terminals_to_graph<uint8_t>(graph, nodes, { 16, 16, 2 }, terminals);
+
+      const auto [fresh_graph, fresh_nodes] = transform::terminals_to_graph({ 16, 16, 2 }, terminals);
+
+      ASSERT_EQ(nodes, fresh_nodes);
+      EXPECT_EQ(algorithms::dijkstra_kruskal_greedy(graph, workspace), algorithms::dijkstra_kruskal_greedy(fresh_graph));
+    }
+}
+
+TEST(AlgorithmsTest, ReuseAfterManyTerminals)
+{
+  std::mt19937                                       random(13);
+
+  algorithms::Workspace                              workspace;
+  graph::Graph                                       graph;
+  std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> nodes;
+
+  /** A sample with many terminals must not change the order in which the next ones are solved */
+  for(std::size_t i = 0; i < 40; ++i)
+    {
+      std::set<uint32_t> indices;
+
+      while(indices.size() < (i % 2 == 0 ? 14 + i % 7 : 2 + i % 4))
+        {
+          indices.insert(random() % (16 * 16));
+        }
+
+      std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> terminals;
+
+      for(const auto index : indices)
+        {
+          terminals.push_back(transform::index_to_coordinates(index, 16));
+        }
+
+      transform::terminals_to_graph<uint8_t>(graph, nodes, { 16, 16, 1 }, terminals);
+
+      const auto [fresh_graph, fresh_nodes] = transform::terminals_to_graph({ 16, 16, 1 }, terminals);
+
+      ASSERT_EQ(nodes, fresh_nodes);
+      ASSERT_EQ(algorithms::dijkstra_kruskal_greedy(graph, workspace), algorithms::dijkstra_kruskal_greedy(fresh_graph)) << "sample " << i;
+    }
+}
+
+TEST(AlgorithmsTest, TiledDijkstraKruskalGreedy)
+{
+  std::mt19937                       random(11);
+
+  /** Samples are tasks of the pool like in the generator, their tiles are shared among its workers */
+  utils::TaskPool                    pool(4);
+  std::vector<algorithms::Workspace> workspaces(pool.size());
+
+  for(std::size_t i = 0; i < 50; ++i)
+    {
+      std::set<uint32_t> indices;
+
+      while(indices.size() < 24)
+        {
+          indices.insert(random() % (128 * 128 * 2));
+        }
+
+      std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> terminals;
+
+      for(const auto index : indices)
+        {
+          terminals.push_back(transform::index_to_coordinates(index, 128));
+        }
+
+      auto instance = std::make_shared<std::pair<graph::Graph, std::vector<matrix::Coordinates<uint8_t>>>>(transform::terminals_to_graph({ 128, 128, 2 }, terminals));
+
+      if(instance->first.get_terminals().size() < 2)
+        {
+          continue;
+        }
+
+      pool.submit([&pool, &workspaces, instance](const std::size_t worker) {
+        const auto& [graph, nodes] = *instance;
+
+        expect_steiner_tree(graph, algorithms::tiled_dijkstra_kruskal_greedy(graph, nodes, 32, 4, pool, worker, workspaces));
+      });
+    }
+
+  pool.wait();
+}
+
+TEST(AlgorithmsTest, SpansTerminals)
+{
+  const std::vector<matrix::Coordinates<uint8_t>> terminals = { { 1, 1, 0 }, { 6, 5, 0 }, { 2, 6, 0 } };
+
+  const auto [graph, nodes]                                 = transform::terminals_to_graph({ 8, 8, 1 }, terminals);
+  const auto tree                                           = algorithms::dijkstra_kruskal_greedy(graph);
+
+  EXPECT_TRUE(algorithms::spans_terminals(graph, tree, terminals.size()));
+  EXPECT_FALSE(algorithms::spans_terminals(graph, { tree.begin(), tree.end() - 1 }, terminals.size()));
+
+  /** A single layer routed along one direction never reaches the terminals of the other rows */
+  const auto [routed_graph, routed_nodes] = transform::terminals_to_graph({ 8, 8, 1 }, terminals, { types::HORIZONTAL_LAYER });
+
+  EXPECT_FALSE(algorithms::spans_terminals(routed_graph, algorithms::dijkstra_kruskal_greedy(routed_graph), terminals.size()));
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,20 +1,278 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <map>
+#include <numeric>
+
 #include "Include/Generator.hpp"
 
 TEST(GeneratorTest, NumberOfCombinations)
 {
-  const uint8_t  size                 = 32;
-  const uint8_t  depth                = 2;
-  const uint8_t  number_of_points     = 5;
-  const uint32_t desired_combinations = 20;
+  const uint8_t     size                 = 32;
+  const uint8_t     depth                = 2;
+  const uint8_t     number_of_points     = 5;
+  const uint32_t    desired_combinations = 20;
+
+  const gen::Rank   total_combinations   = gen::nCr(size * size * depth, number_of_points);
+  const gen::Rank   step                 = total_combinations / desired_combinations;
+
+  gen::GeneratorItr itr(size * size * depth, number_of_points, step, 0, step * desired_combinations);
+  gen::GeneratorItr itr_end(size * size * depth, number_of_points, step, step * desired_combinations, step * desired_combinations);
+
+  std::size_t       combinations = 0;
+
+  for(; itr < itr_end; ++itr)
+    {
+      EXPECT_EQ((*itr).size(), number_of_points);
+      ++combinations;
+    }
+
+  EXPECT_EQ(combinations, desired_combinations);
+}
+
+TEST(GeneratorTest, LexicographicOrder)
+{
+  const uint32_t                           length           = 5;
+  const uint8_t                            number_of_points = 2;
+  const gen::Rank                          total            = gen::nCr(length, number_of_points);
+
+  const std::vector<std::vector<uint32_t>> expected         = { { 0, 1 }, { 0, 2 }, { 0, 3 }, { 0, 4 }, { 1, 2 }, { 1, 3 }, { 1, 4 }, { 2, 3 }, { 2, 4 }, { 3, 4 } };
+
+  gen::GeneratorItr                  itr(length, number_of_points, 1, 0, total);
+  gen::GeneratorItr                  itr_end(length, number_of_points, 1, total, total);
+
+  std::vector<std::vector<uint32_t>> combinations;
+
+  for(; itr < itr_end; ++itr)
+    {
+      combinations.emplace_back((*itr).begin(), (*itr).end());
+    }
+
+  EXPECT_EQ(total, 10);
+  EXPECT_EQ(combinations, expected);
+}
+
+TEST(GeneratorTest, BinomialTable)
+{
+  const gen::BinomialTable table(40, 6);
+
+  for(uint32_t n = 0; n <= 40; ++n)
+    {
+      for(uint8_t r = 0; r <= 6; ++r)
+        {
+          EXPECT_EQ(table.nCr(n, r), gen::nCr(n, r));
+        }
+    }
+}
+
+TEST(GeneratorTest, UnrankingFollowsLexicographicOrder)
+{
+  for(const auto& [length, number_of_points] : std::vector<std::pair<uint32_t, uint8_t>>{ { 1, 1 }, { 6, 1 }, { 7, 3 }, { 9, 9 }, { 12, 5 } })
+    {
+      const gen::BinomialTable table(length, number_of_points);
+      const uint64_t           total = table.nCr(length, number_of_points);
+
+      std::vector<uint32_t>    expected(number_of_points);
+      std::vector<uint32_t>    combination(number_of_points);
+
+      for(uint8_t i = 0; i < number_of_points; ++i)
+        {
+          expected[i] = i;
+        }
+
+      for(uint64_t rank = 0; rank < total; ++rank)
+        {
+          table.unrank(combination, rank);
+          ASSERT_EQ(combination, expected);
+
+          /** Next combination in lexicographical order */
+          int32_t i = number_of_points - 1;
+
+          while(i >= 0 && expected[i] == length - number_of_points + i)
+            {
+              --i;
+            }
+
+          if(i >= 0)
+            {
+              ++expected[i];
+              std::iota(expected.begin() + i + 1, expected.end(), expected[i] + 1);
+            }
+        }
+    }
+}
+
+TEST(GeneratorTest, AdvanceMatchesUnranking)
+{
+  const gen::BinomialTable table(14, 4);
+  const uint64_t           total = table.nCr(14, 4);
+
+  for(const uint64_t step : { 1, 2, 3, 7, 13, 64, 300 })
+    {
+      std::vector<uint32_t> combination(4);
+      std::vector<uint32_t> expected(4);
+
+      table.unrank(combination, 0);
+
+      for(uint64_t rank = step; rank < total; rank += step)
+        {
+          table.advance(combination, step);
+          table.unrank(expected, rank);
+
+          ASSERT_EQ(combination, expected);
+        }
+    }
+}
+
+TEST(GeneratorTest, TableServesFewerPoints)
+{
+  /** The table of the most points holds the columns of every lower number */
+  const auto shared = std::make_shared<const gen::BinomialTable>(20, 6);
+
+  for(uint8_t number_of_points = 1; number_of_points <= 6; ++number_of_points)
+    {
+      const auto      own   = std::make_shared<const gen::BinomialTable>(20, number_of_points);
+      const gen::Rank total = own->nCr(20, number_of_points);
+
+      ASSERT_TRUE(shared->nCr(20, number_of_points) == total);
+
+      for(const gen::Rank step : { 1, 5, 37 })
+        {
+          gen::GeneratorItr itr(shared, number_of_points, step, 0, total);
+          gen::GeneratorItr itr_end(shared, number_of_points, step, total, total);
+          gen::GeneratorItr expected(own, number_of_points, step, 0, total);
+
+          for(; itr < itr_end; ++itr, ++expected)
+            {
+              ASSERT_TRUE(std::ranges::equal(*itr, *expected));
+            }
+        }
+    }
+}
+
+TEST(GeneratorTest, TableOfLargeGrid)
+{
+  /** 65535 x 65535 cells would take 343 GB of table, the coefficients are computed instead */
+  const uint32_t           length = 65535u * 65535u;
+  const gen::BinomialTable table(length, 4);
+
+  EXPECT_TRUE(table.nCr(length, 4) == gen::nCr(length, 4));
+  EXPECT_THROW(gen::BinomialTable(length, 10), std::overflow_error);
+
+  /** A combination ranks as nCk - 1 minus the combinations that follow it */
+  auto rank_of = [length](const std::vector<uint32_t>& combination) {
+    gen::Rank rank = gen::nCr(length, combination.size()) - 1;
+
+    for(std::size_t i = 0; i < combination.size(); ++i)
+      {
+        rank -= gen::nCr(length - 1 - combination[i], combination.size() - i);
+      }
+
+    return rank;
+  };
+
+  const gen::Rank       total = table.nCr(length, 4);
+  std::vector<uint32_t> combination(4);
+
+  for(const gen::Rank rank : { gen::Rank(0), gen::Rank(1), total / 3, total / 2, total - 2, total - 1 })
+    {
+      table.unrank(combination, rank);
+      EXPECT_TRUE(rank_of(combination) == rank);
+    }
+
+  table.unrank(combination, total / 5);
+  table.advance(combination, total / 7);
+  EXPECT_TRUE(rank_of(combination) == total / 5 + total / 7);
+}
+
+TEST(GeneratorTest, LargeCombinationSpace)
+{
+  /** 1024C10 needs 75 bits */
+  const gen::Rank total = gen::Rank(18120) << 64 | 10864883005070337536ull;
+
+  EXPECT_TRUE(gen::nCr(1024, 10) == total);
+  EXPECT_TRUE(gen::nCr(65025, 9) > gen::Rank(UINT64_MAX));
+  EXPECT_THROW(gen::nCr(65025, 10), std::overflow_error);
+  EXPECT_THROW(gen::BinomialTable(65025, 10), std::overflow_error);
+
+  const auto            table = std::make_shared<const gen::BinomialTable>(1024, 10);
+  std::vector<uint32_t> combination(10);
+
+  EXPECT_TRUE(table->nCr(1024, 10) == total);
+
+  table->unrank(combination, total / 2);
+  EXPECT_EQ(combination, std::vector<uint32_t>({ 68, 102, 119, 175, 242, 604, 655, 749, 873, 1016 }));
+
+  table->unrank(combination, total - 1);
+  EXPECT_EQ(combination, std::vector<uint32_t>({ 1014, 1015, 1016, 1017, 1018, 1019, 1020, 1021, 1022, 1023 }));
+
+  /** Parts of the space handed to workers stay in order and end at the last combination */
+  const gen::Rank       step = total / 7 + 1;
+  gen::GeneratorItr     itr(table, 10, step, 0, total);
+  gen::GeneratorItr     itr_end(table, 10, step, total, total);
+  std::vector<uint32_t> previous;
+  std::size_t           count = 0;
+
+  for(; itr < itr_end; ++itr, ++count)
+    {
+      const std::vector<uint32_t> current((*itr).begin(), (*itr).end());
+
+      EXPECT_LT(previous, current);
+      previous = current;
+    }
+
+  EXPECT_EQ(count, 7);
+}
+
+TEST(GeneratorTest, RandomCombinationsAreUniform)
+{
+  /** 6C2 is 15, every combination should be drawn about a thousand times */
+  std::map<std::vector<uint32_t>, std::size_t> counts;
+
+  gen::RandomItr                               itr(6, 2, 42, 0, 15000);
+  gen::RandomItr                               itr_end(6, 2, 42, 15000, 15000);
+
+  for(; itr < itr_end; ++itr)
+    {
+      ++counts[std::vector<uint32_t>((*itr).begin(), (*itr).end())];
+    }
+
+  EXPECT_EQ(counts.size(), 15);
+
+  for(const auto& [combination, count] : counts)
+    {
+      EXPECT_LT(combination[0], combination[1]);
+      EXPECT_LT(combination[1], 6);
+      EXPECT_NEAR(double(count), 1000.0, 150.0);
+    }
+}
+
+TEST(GeneratorTest, RandomSamplesDontDependOnTheSplit)
+{
+  auto draw = [](const uint64_t seed, const uint64_t start, const uint64_t end) {
+    std::vector<std::vector<uint32_t>> samples;
+
+    for(gen::RandomItr itr(1024, 5, seed, start, end), itr_end(1024, 5, seed, end, end); itr < itr_end; ++itr)
+      {
+        samples.emplace_back((*itr).begin(), (*itr).end());
+      }
+
+    return samples;
+  };
+
+  std::vector<std::vector<uint32_t>>       split = draw(7, 0, 37);
+  const std::vector<std::vector<uint32_t>> rest  = draw(7, 37, 100);
 
-  const uint64_t total_combinations   = gen::nCr(size * size * depth, number_of_points);
-  const uint32_t step                 = total_combinations / desired_combinations;
+  split.insert(split.end(), rest.begin(), rest.end());
 
-  const auto     combinations         = gen::make_combinations_3d(size, depth, number_of_points, step, desired_combinations);
+  EXPECT_EQ(split, draw(7, 0, 100));
+  EXPECT_NE(draw(7, 0, 100), draw(8, 0, 100));
 
-  EXPECT_EQ(combinations.size(), desired_combinations * number_of_points);
+  for(const auto& sample : split)
+    {
+      EXPECT_TRUE(std::adjacent_find(sample.begin(), sample.end(), std::greater_equal<uint32_t>()) == sample.end());
+      EXPECT_LT(sample.back(), 1024);
+    }
 }
 
 int
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <Include/BitPlaneMatrix.hpp>
+#include <Include/Kernels.hpp>
 #include <Include/Matrix.hpp>
+#include <Include/Types.hpp>
 
 TEST(MatrixTest, CreateEmptyMatrix)
 {
@@ -105,6 +108,206 @@ TEST(MatrixTest, MoveAssign)
   });
 }
 
+TEST(MatrixTest, Fill)
+{
+  matrix::Matrix matrix({ 3, 3, 2 });
+  matrix.fill(7);
+
+  for(uint8_t x = 0; x < 3; ++x)
+    {
+      for(uint8_t y = 0; y < 3; ++y)
+        {
+          for(uint8_t z = 0; z < 2; ++z)
+            {
+              EXPECT_EQ(matrix.get_at(x, y, z), 7);
+            }
+        }
+    }
+
+  matrix::Matrix empty_matrix({ 0, 0, 0 });
+  EXPECT_NO_THROW(empty_matrix.fill(0));
+}
+
+TEST(MatrixTest, WideExtent)
+{
+  matrix::Matrix16       matrix({ 300, 300, 2 });
+
+  const matrix::Shape16& shape = matrix.shape();
+
+  EXPECT_EQ(shape.m_x, 300);
+  EXPECT_EQ(shape.m_y, 300);
+  EXPECT_EQ(shape.m_z, 2);
+
+  matrix.set_at(7, 299, 280, 1);
+  matrix.set_at(9, 280, 299, 0);
+
+  EXPECT_EQ(matrix.get_at(299, 280, 1), 7);
+  EXPECT_EQ(matrix.get_at(280, 299, 0), 9);
+  EXPECT_EQ(matrix.get_at(299, 280, 0), 0);
+
+  EXPECT_THROW(matrix.get_at(300, 0, 0), std::out_of_range);
+}
+
+TEST(MatrixTest, View)
+{
+  matrix::Matrix matrix({ 4, 4, 3 });
+
+  for(uint8_t x = 0; x < 4; ++x)
+    {
+      for(uint8_t y = 0; y < 4; ++y)
+        {
+          for(uint8_t z = 0; z < 3; ++z)
+            {
+              matrix.set_at(x * 16 + y * 4 + z, x, y, z);
+            }
+        }
+    }
+
+  const auto view = matrix.view<matrix::CheckedAccess>();
+
+  EXPECT_EQ(view(3, 2, 1), matrix.get_at(3, 2, 1));
+  EXPECT_EQ(std::vector<uint8_t>(view.row(2, 1).begin(), view.row(2, 1).end()), std::vector<uint8_t>({ 9, 25, 41, 57 }));
+  EXPECT_EQ(std::vector<uint8_t>(view.column(3, 1).begin(), view.column(3, 1).end()), std::vector<uint8_t>({ 49, 53, 57, 61 }));
+  EXPECT_EQ(std::vector<uint8_t>(view.pillar(3, 2).begin(), view.pillar(3, 2).end()), std::vector<uint8_t>({ 56, 57, 58 }));
+
+  view.pillar(1, 1)[2] = 0;
+  EXPECT_EQ(matrix.get_at(1, 1, 2), 0);
+
+  EXPECT_THROW(view(4, 0, 0), std::out_of_range);
+  EXPECT_THROW(view.row(0, 3), std::out_of_range);
+  EXPECT_THROW(view.pillar(0, 0)[3], std::out_of_range);
+
+  const matrix::Matrix& const_matrix = matrix;
+  EXPECT_EQ(const_matrix.view<matrix::UncheckedAccess>()(3, 2, 1), 57);
+}
+
+TEST(MatrixTest, BitPlaneFill)
+{
+  matrix::BitPlaneMatrix planes({ 70, 70, 2 });
+
+  planes.set_at(types::TERMINAL_CELL, 3, 5, 1);
+  planes.set_at(types::TRACE_CELL, 66, 5, 1);
+  planes.fill_row(5, 1, types::INTERSECTION_CELL);
+
+  EXPECT_EQ(planes.get_at(3, 5, 1), types::TERMINAL_CELL);
+  EXPECT_EQ(planes.get_at(66, 5, 1), types::INTERSECTION_CELL);
+  EXPECT_EQ(planes.get_at(69, 5, 1), types::TRACE_CELL);
+  EXPECT_EQ(planes.get_at(69, 5, 0), 0);
+
+  planes.fill_pillar(66, 5, types::INTERSECTION_VIA_CELL);
+
+  EXPECT_EQ(planes.get_at(66, 5, 0), types::TRACE_CELL);
+  EXPECT_EQ(planes.get_at(66, 5, 1), types::INTERSECTION_VIA_CELL);
+
+  /** A line without empty cells isn't filled */
+  planes.fill_pillar(66, 5, types::INTERSECTION_CELL);
+
+  EXPECT_EQ(planes.get_at(66, 5, 0), types::TRACE_CELL);
+
+  const matrix::Matrix matrix = planes.to_matrix();
+
+  EXPECT_EQ(matrix.get_at(3, 5, 1), types::TERMINAL_CELL);
+  EXPECT_EQ(matrix.get_at(66, 5, 1), types::INTERSECTION_VIA_CELL);
+  EXPECT_EQ(matrix.get_at(66, 5, 0), types::TRACE_CELL);
+
+  const matrix::BitPlaneMatrix round_trip(matrix);
+
+  for(uint8_t x = 0; x < 70; ++x)
+    {
+      EXPECT_EQ(round_trip.get_at(x, 5, 1), planes.get_at(x, 5, 1));
+    }
+
+  EXPECT_THROW(planes.set_at(6, 0, 0, 0), std::invalid_argument);
+}
+
+namespace
+{
+
+/**
+ * @brief Checks that a matrix of the layout holds the same cells as the row-major one.
+ *
+ * @tparam LayoutMatrix The matrix type of the layout.
+ * @param shape The shape of the matrices.
+ */
+template <typename LayoutMatrix>
+void
+expect_same_as_row_major(const matrix::Shape& shape)
+{
+  matrix::Matrix row_major(shape);
+  LayoutMatrix   layout(shape);
+
+  for(uint8_t x = 0; x < shape.m_x; ++x)
+    {
+      for(uint8_t y = 0; y < shape.m_y; ++y)
+        {
+          for(uint8_t z = 0; z < shape.m_z; ++z)
+            {
+              row_major.set_at(x * 7 + y * 3 + z, x, y, z);
+              layout.set_at(x * 7 + y * 3 + z, x, y, z);
+            }
+        }
+    }
+
+  std::size_t cells = 0;
+
+  layout.for_each([&](const uint8_t x, const uint8_t y, const uint8_t z, const uint8_t value) {
+    EXPECT_EQ(value, row_major.get_at(x, y, z));
+    ++cells;
+  });
+
+  EXPECT_EQ(cells, std::size_t(shape.m_x) * shape.m_y * shape.m_z);
+
+  const matrix::Matrix converted = layout.to_row_major();
+  const LayoutMatrix   restored  = LayoutMatrix::from_row_major(row_major);
+
+  EXPECT_TRUE(std::equal(row_major.data(), row_major.data() + cells, converted.data()));
+  EXPECT_EQ(restored.get_at(shape.m_x - 1, shape.m_y - 1, shape.m_z - 1), row_major.get_at(shape.m_x - 1, shape.m_y - 1, shape.m_z - 1));
+}
+
+} // namespace
+
+TEST(MatrixTest, MortonLayout)
+{
+  expect_same_as_row_major<matrix::MortonMatrix>({ 13, 13, 3 });
+  expect_same_as_row_major<matrix::MortonMatrix>({ 16, 16, 1 });
+}
+
+TEST(MatrixTest, BrickLayout)
+{
+  expect_same_as_row_major<matrix::BrickMatrix>({ 13, 13, 3 });
+  expect_same_as_row_major<matrix::BrickMatrix>({ 16, 16, 1 });
+}
+
+TEST(MatrixTest, Kernels)
+{
+  /** Lengths around the vector widths and the blocks of the search */
+  for(std::size_t length = 0; length <= 200; ++length)
+    {
+      std::vector<uint8_t> line(length, 0);
+
+      for(std::size_t i = 0; i < length; ++i)
+        {
+          line[i] = (i * 7 + length) % 3 == 0 ? 0 : uint8_t((i * 5) % 6);
+        }
+
+      std::vector<uint8_t> expected = line;
+
+      for(auto& value : expected)
+        {
+          value = value == 0 ? types::TRACE_CELL : (value == types::TERMINAL_CELL ? value : types::INTERSECTION_CELL);
+        }
+
+      for(const uint8_t value : { 0, 4, 5 })
+        {
+          EXPECT_EQ(kernels::contains(line.data(), length, value), std::find(line.begin(), line.end(), value) != line.end());
+        }
+
+      kernels::fill_line(line.data(), length, types::INTERSECTION_CELL);
+
+      EXPECT_EQ(line, expected);
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
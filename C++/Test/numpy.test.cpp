@@ -13,6 +13,65 @@ TEST(NumpyTest, SaveData)
       });
 }
 
+TEST(NumpyTest, MappedArray)
+{
+  std::vector<uint8_t> cells(3 * 3 * 2);
+
+  for(std::size_t i = 0; i < cells.size(); ++i)
+    {
+      cells[i] = uint8_t(i);
+    }
+
+  numpy::save_as<uint8_t>("./mapped.npy", reinterpret_cast<const char*>(cells.data()), std::vector<std::size_t>{ 2, 3, 3 });
+
+  const numpy::MappedArray array("./mapped.npy");
+
+  EXPECT_EQ(array.shape(), std::vector<std::size_t>({ 2, 3, 3 }));
+  EXPECT_EQ(array.kind(), 'u');
+  EXPECT_EQ(array.item_size(), 1);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array.data()) % 16, 0);
+
+  const std::span<const uint8_t> data = array.as<uint8_t>();
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), cells.begin(), cells.end()));
+  EXPECT_THROW(array.as<uint16_t>(), std::invalid_argument);
+
+  /** The view reads the payload in matrix memory order, depth is the first dimension */
+  const auto view = array.view();
+
+  EXPECT_EQ(view.shape().m_x, 3);
+  EXPECT_EQ(view.shape().m_y, 3);
+  EXPECT_EQ(view.shape().m_z, 2);
+  EXPECT_EQ(&view(1, 2, 0), data.data() + 2 * 3 * 2 + 1 * 2 + 1);
+}
+
+TEST(NumpyTest, MappedArrayTypes)
+{
+  const std::vector<uint16_t> values = { 1, 700, 65535 };
+
+  numpy::save_as<uint16_t>("./mapped_u2.npy", reinterpret_cast<const char*>(values.data()), std::vector<std::size_t>{ 3 });
+
+  numpy::MappedArray array("./mapped_u2.npy");
+  numpy::MappedArray moved(std::move(array));
+
+  EXPECT_EQ(moved.shape(), std::vector<std::size_t>({ 3 }));
+  EXPECT_EQ(std::vector<uint16_t>(moved.as<uint16_t>().begin(), moved.as<uint16_t>().end()), values);
+  EXPECT_THROW(moved.view(), std::invalid_argument);
+}
+
+TEST(NumpyTest, MappedArrayRejectsInvalidFiles)
+{
+  EXPECT_THROW(numpy::MappedArray("./missing.npy"), std::runtime_error);
+
+  std::ofstream("./invalid.npy", std::ios::binary) << "not a numpy array";
+  EXPECT_THROW(numpy::MappedArray("./invalid.npy"), std::runtime_error);
+
+  /** A payload shorter than the shape */
+  const std::vector<uint8_t> cells(8);
+  numpy::save_as<uint8_t>("./truncated.npy", reinterpret_cast<const char*>(cells.data()), std::vector<std::size_t>{ 8 });
+  std::filesystem::resize_file("./truncated.npy", std::filesystem::file_size("./truncated.npy") - 1);
+  EXPECT_THROW(numpy::MappedArray("./truncated.npy"), std::runtime_error);
+}
+
 int
 main(int argc, char* argv[])
 {
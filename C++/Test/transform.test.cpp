@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include "Include/Generator.hpp"
+#include "Include/Transform.hpp"
+
+namespace
+{
+
+/**
+ * @brief Checks that both ways of building the graph, and both ways of rasterizing the
+ * terrain, agree on every sampled combination.
+ *
+ * @tparam Extent The type of a coordinate.
+ * @param size The size of the grid.
+ * @param depth The depth of the grid.
+ * @param number_of_points The number of terminals.
+ * @param desired_combinations The number of combinations to check.
+ * @param layer_directions The routing directions of layers.
+ */
+template <typename Extent = uint8_t>
+void
+expect_same_graphs(const std::type_identity_t<Extent> size, const std::type_identity_t<Extent> depth, const uint8_t number_of_points, const uint32_t desired_combinations, const std::vector<uint8_t>& layer_directions = {})
+{
+  const uint32_t    total_cells  = uint32_t(size) * size * depth;
+  const gen::Rank   combinations = gen::nCr(total_cells, number_of_points);
+  const gen::Rank   step         = std::max<gen::Rank>(combinations / desired_combinations, 1);
+
+  gen::GeneratorItr itr(total_cells, number_of_points, step, 0, combinations);
+  gen::GeneratorItr itr_end(total_cells, number_of_points, step, combinations, combinations);
+
+  for(; itr < itr_end; ++itr)
+    {
+      std::vector<matrix::Coordinates<Extent>> terminals;
+
+      for(const auto index : *itr)
+        {
+          terminals.push_back(transform::index_to_coordinates<Extent>(index, size));
+        }
+
+      const matrix::BasicMatrix<Extent> source_matrix = transform::terminals_to_matrix<Extent>({ size, size, depth }, terminals);
+      const matrix::BasicMatrix<Extent> planes_matrix = transform::terminals_to_bit_planes<Extent>({ size, size, depth }, terminals).to_matrix();
+
+      ASSERT_TRUE(std::equal(source_matrix.data(), source_matrix.data() + std::size_t(size) * size * depth, planes_matrix.data()));
+
+      const auto [matrix_graph, matrix_nodes] = transform::matrix_to_graph(source_matrix, terminals.front(), layer_directions);
+      const auto [direct_graph, direct_nodes] = transform::terminals_to_graph<Extent>({ size, size, depth }, terminals, layer_directions);
+
+      ASSERT_EQ(matrix_nodes, direct_nodes);
+      ASSERT_EQ(matrix_graph.get_terminals(), direct_graph.get_terminals());
+      ASSERT_EQ(matrix_graph.get_adj().size(), direct_graph.get_adj().size());
+
+      for(std::size_t i = 0, end = matrix_graph.get_adj().size(); i < end; ++i)
+        {
+          const auto& matrix_edges = matrix_graph.get_adj()[i];
+          const auto& direct_edges = direct_graph.get_adj()[i];
+
+          ASSERT_EQ(matrix_edges.size(), direct_edges.size());
+
+          for(std::size_t j = 0, edges = matrix_edges.size(); j < edges; ++j)
+            {
+              EXPECT_EQ(matrix_edges[j], direct_edges[j]);
+              EXPECT_EQ(matrix_edges[j].m_weight, direct_edges[j].m_weight);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(TransformTest, TerminalsToMatrix)
+{
+  const matrix::Matrix matrix = transform::terminals_to_matrix({ 4, 4, 1 }, { { 1, 1, 0 }, { 3, 3, 0 } });
+
+  EXPECT_EQ(matrix.get_at(1, 1, 0), types::TERMINAL_CELL);
+  EXPECT_EQ(matrix.get_at(3, 3, 0), types::TERMINAL_CELL);
+  EXPECT_EQ(matrix.get_at(3, 1, 0), types::INTERSECTION_CELL);
+  EXPECT_EQ(matrix.get_at(1, 3, 0), types::INTERSECTION_CELL);
+  EXPECT_EQ(matrix.get_at(0, 1, 0), types::TRACE_CELL);
+  EXPECT_EQ(matrix.get_at(2, 2, 0), 0);
+}
+
+TEST(TransformTest, MstToMatrix)
+{
+  const std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> nodes  = { { 1, 1, 0 }, { 4, 1, 0 }, { 4, 1, 2 }, { 4, 3, 2 }, { 0, 3, 2 } };
+  const std::vector<std::pair<uint32_t, uint32_t>>         mst    = { { 2, 1 }, { 2, 3 }, { 4, 3 }, { 4, 5 } };
+
+  matrix::Matrix                                           matrix({ 5, 5, 3 });
+  matrix.fill(types::TRACE_CELL);
+
+  transform::mst_to_matrix(matrix, mst, nodes);
+
+  matrix::Matrix expected({ 5, 5, 3 });
+
+  for(uint8_t x = 1; x <= 4; ++x)
+    {
+      expected.set_at(types::PATH_CELL, x, 1, 0);
+    }
+
+  for(uint8_t z = 0; z <= 2; ++z)
+    {
+      expected.set_at(types::PATH_CELL, 4, 1, z);
+    }
+
+  for(uint8_t y = 1; y <= 3; ++y)
+    {
+      expected.set_at(types::PATH_CELL, 4, y, 2);
+    }
+
+  for(uint8_t x = 0; x <= 4; ++x)
+    {
+      expected.set_at(types::PATH_CELL, x, 3, 2);
+    }
+
+  EXPECT_EQ(std::vector<uint8_t>(matrix.data(), matrix.data() + 5 * 5 * 3), std::vector<uint8_t>(expected.data(), expected.data() + 5 * 5 * 3));
+}
+
+TEST(TransformTest, TerminalsToFeatures)
+{
+  const matrix::Shape                                      shape     = { 7, 7, 3 };
+  const std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> terminals = { { 1, 2, 0 }, { 5, 3, 2 }, { 3, 6, 0 } };
+
+  std::vector<uint16_t>                                    features;
+  transform::terminals_to_features(features, shape, terminals);
+
+  ASSERT_EQ(features.size(), 2 * 7 * 7 * 3);
+
+  for(uint8_t y = 0; y < 7; ++y)
+    {
+      for(uint8_t x = 0; x < 7; ++x)
+        {
+          for(uint8_t z = 0; z < 3; ++z)
+            {
+              uint16_t distance = UINT16_MAX;
+
+              for(const auto& [t_x, t_y, t_z] : terminals)
+                {
+                  distance = std::min<uint16_t>(distance, std::abs(x - t_x) + std::abs(y - t_y) + std::abs(z - t_z));
+                }
+
+              const std::size_t index  = y * 7 * 3 + x * 3 + (3 - z - 1);
+              const bool        in_box = x >= 1 && x <= 5 && y >= 2 && y <= 6;
+
+              EXPECT_EQ(features[index], distance);
+              EXPECT_EQ(features[7 * 7 * 3 + index], in_box ? 1 : 0);
+            }
+        }
+    }
+}
+
+TEST(TransformTest, MstToSparse)
+{
+  const std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> nodes = { { 0, 0, 0 }, { 2, 0, 0 }, { 4, 0, 0 }, { 2, 3, 0 }, { 4, 2, 0 }, { 2, 1, 0 } };
+  const std::vector<std::pair<uint32_t, uint32_t>>         mst   = { { 1, 2 }, { 2, 3 }, { 2, 6 }, { 6, 4 }, { 3, 5 } };
+
+  const transform::SparseTree                              tree  = transform::mst_to_sparse(mst, nodes);
+
+  EXPECT_EQ(tree.m_points, std::vector<uint8_t>({ 0, 0, 0, 2, 0, 0, 4, 0, 0, 2, 3, 0, 4, 2, 0 }));
+  EXPECT_EQ(tree.m_segments, std::vector<uint32_t>({ 0, 1, 1, 2, 1, 3, 2, 4 }));
+
+  const matrix::Matrix expected = transform::mst_to_matrix({ 5, 4, 2 }, mst, nodes);
+  matrix::Matrix       matrix({ 5, 4, 2 });
+  matrix.fill(types::TRACE_CELL);
+
+  transform::sparse_to_matrix(matrix, tree);
+
+  EXPECT_EQ(std::vector<uint8_t>(matrix.data(), matrix.data() + 5 * 4 * 2), std::vector<uint8_t>(expected.data(), expected.data() + 5 * 4 * 2));
+}
+
+TEST(TransformTest, GraphToCsr)
+{
+  const std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> nodes = { { 0, 0, 0 }, { 3, 0, 0 }, { 3, 2, 0 } };
+  const std::vector<std::pair<uint32_t, uint32_t>>         mst   = { { 2, 1 }, { 2, 3 } };
+
+  graph::Graph                                             graph;
+
+  for(std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      graph.place_node();
+    }
+
+  graph.add_terminal(0);
+  graph.add_terminal(2);
+  graph.add_edge(3, 0, 1);
+  graph.add_edge(2, 1, 2);
+  graph.add_edge(5, 0, 2);
+
+  const transform::CsrGraph csr = transform::graph_to_csr(graph, nodes, mst);
+
+  EXPECT_EQ(csr.m_features, std::vector<uint8_t>({ 0, 0, 0, 1, 3, 0, 0, 0, 3, 2, 0, 1 }));
+  EXPECT_EQ(csr.m_indptr, std::vector<uint32_t>({ 0, 2, 4, 6 }));
+  EXPECT_EQ(csr.m_indices, std::vector<uint32_t>({ 1, 2, 0, 2, 1, 0 }));
+  EXPECT_EQ(csr.m_weights, std::vector<uint32_t>({ 3, 5, 3, 2, 2, 5 }));
+  EXPECT_EQ(csr.m_labels, std::vector<uint8_t>({ 1, 0, 1, 1, 1, 0 }));
+}
+
+TEST(TransformTest, DirectGraphMatchesMatrixGraph)
+{
+  /** Settings of the generator config */
+  for(uint8_t number_of_points = 2; number_of_points <= 5; ++number_of_points)
+    {
+      expect_same_graphs(32, 1, number_of_points, 500);
+    }
+}
+
+TEST(TransformTest, DirectGraphMatchesMatrixGraphStacked)
+{
+  for(uint8_t number_of_points = 2; number_of_points <= 5; ++number_of_points)
+    {
+      expect_same_graphs(6, 3, number_of_points, 500);
+      expect_same_graphs(2, 2, number_of_points, 500);
+    }
+}
+
+TEST(TransformTest, DirectGraphMatchesMatrixGraphWide)
+{
+  expect_same_graphs<uint16_t>(300, 1, 3, 50);
+  expect_same_graphs<uint16_t>(260, 2, 4, 50);
+}
+
+TEST(TransformTest, LayerDirections)
+{
+  const std::vector<uint8_t> layer_directions = { types::HORIZONTAL_LAYER, types::VERTICAL_LAYER };
+
+  for(uint8_t number_of_points = 2; number_of_points <= 5; ++number_of_points)
+    {
+      expect_same_graphs(8, 4, number_of_points, 300, layer_directions);
+    }
+
+  const auto [graph, nodes] = transform::terminals_to_graph({ 8, 8, 2 }, { { 1, 1, 0 }, { 5, 3, 0 }, { 3, 6, 1 } }, layer_directions);
+
+  std::size_t edges         = 0;
+
+  for(const auto& node_edges : graph.get_adj())
+    {
+      for(const auto& edge : node_edges)
+        {
+          const auto [s_x, s_y, s_z] = nodes[edge.m_source - 1];
+          const auto [d_x, d_y, d_z] = nodes[edge.m_destination - 1];
+
+          if(s_z == d_z)
+            {
+              EXPECT_EQ(s_z == 0 ? s_x == d_x : s_y == d_y, false);
+            }
+
+          ++edges;
+        }
+    }
+
+  EXPECT_GT(edges, 0);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+
+#include "Include/Utilis.hpp"
+
+TEST(UtilsTest, AvailableCpus)
+{
+  EXPECT_GE(utils::available_cpus(), 1);
+  EXPECT_LE(utils::available_cpus(), std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+}
+
+TEST(UtilsTest, TaskPoolRunsEveryTaskOnce)
+{
+  utils::TaskPool               pool(4);
+  std::vector<std::atomic<int>> runs(1000);
+
+  /** The pool outlives a wait, tasks of later rounds go to the same workers */
+  for(int round = 1; round <= 3; ++round)
+    {
+      for(std::size_t i = 0; i < runs.size(); ++i)
+        {
+          pool.submit([&runs, i](const std::size_t worker) {
+            ASSERT_LT(worker, 4);
+            ++runs[i];
+          });
+        }
+
+      pool.wait();
+
+      for(const auto& count : runs)
+        {
+          EXPECT_EQ(count, round);
+        }
+    }
+}
+
+TEST(UtilsTest, TaskPoolStealsWork)
+{
+  utils::TaskPool                 pool(2);
+  std::array<std::atomic<int>, 2> tasks_of_worker{};
+
+  /** One worker blocks until all other tasks are done, so the ones queued behind it must be stolen */
+  std::atomic<bool>               released = false;
+
+  pool.submit([&](const std::size_t) {
+    while(!released)
+      {
+        std::this_thread::yield();
+      }
+  });
+
+  for(int i = 0; i < 99; ++i)
+    {
+      pool.submit([&](const std::size_t worker) { ++tasks_of_worker[worker]; });
+    }
+
+  while(tasks_of_worker[0] + tasks_of_worker[1] < 99)
+    {
+      std::this_thread::yield();
+    }
+
+  released = true;
+  pool.wait();
+
+  EXPECT_EQ(tasks_of_worker[0] + tasks_of_worker[1], 99);
+}
+
+TEST(UtilsTest, TaskPoolRethrows)
+{
+  utils::TaskPool pool(3);
+
+  for(int i = 0; i < 10; ++i)
+    {
+      pool.submit([i](const std::size_t) {
+        if(i == 5)
+          {
+            throw std::runtime_error("failed");
+          }
+      });
+    }
+
+  EXPECT_THROW(pool.wait(), std::runtime_error);
+
+  /** The error is reported once */
+  pool.submit([](const std::size_t) {});
+  EXPECT_NO_THROW(pool.wait());
+}
+
+TEST(UtilsTest, TaskPoolRunsJobsOfATask)
+{
+  utils::TaskPool               pool(3);
+  std::vector<std::atomic<int>> runs(30 * 64);
+
+  /** Every task waits on its own jobs only, while the other tasks keep the workers busy */
+  for(std::size_t t = 0; t < 30; ++t)
+    {
+      pool.submit([&pool, &runs, t](const std::size_t worker) {
+        pool.for_each(worker, 64, [&runs, t](const std::size_t job, const std::size_t job_worker) {
+          ASSERT_LT(job_worker, 3);
+          ++runs[t * 64 + job];
+        });
+
+        for(std::size_t job = 0; job < 64; ++job)
+          {
+            EXPECT_EQ(runs[t * 64 + job], 1);
+          }
+      });
+    }
+
+  pool.wait();
+
+  pool.submit([&pool](const std::size_t worker) {
+    EXPECT_THROW(pool.for_each(worker, 8, [](const std::size_t job, const std::size_t) {
+      if(job == 3)
+        {
+          throw std::runtime_error("failed");
+        }
+    }),
+                 std::runtime_error);
+  });
+
+  EXPECT_NO_THROW(pool.wait());
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
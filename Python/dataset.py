@@ -7,6 +7,34 @@ import torch
 from tqdm import tqdm
 
 
+def densify(points, segments, shape):
+    """
+    Rasterizes a sparse solution tree into a dense target.
+
+    Args:
+        points (np.ndarray): Points of the tree as (n, 3) rows of x, y, z.
+        segments (np.ndarray): Axis-aligned segments as (m, 2) rows of point indices.
+        shape (tuple): Shape of the target as (depth, height, width).
+
+    Returns:
+        np.ndarray: The target with path cells set to 1.
+    """
+
+    # Targets keep the memory order of the generator's matrix: y, x and then reversed depth
+    depth = shape[0]
+    target = np.zeros((shape[1], shape[2], depth), dtype=np.uint8)
+
+    for first, second in segments:
+        low = np.minimum(points[first], points[second]).astype(np.int64)
+        high = np.maximum(points[first], points[second]).astype(np.int64)
+
+        target[low[1]:high[1] + 1, low[0]:high[0] + 1, depth - 1 - high[2]:depth - low[2]] = 1
+
+    target = target.reshape(shape)
+
+    return target
+
+
 class SimpleDataset(Dataset):
     def __init__(self, assets_dir, image_size, preload_percentage=0.0):
         """
@@ -24,8 +52,16 @@ class SimpleDataset(Dataset):
         self.preload_percentage = preload_percentage
 
         self.source_files = sorted(os.listdir(self.source_dir))
-        self.target_files = sorted(os.listdir(self.target_dir))
-        self.nodes_files = sorted(os.listdir(self.nodes_dir))
+
+        # Sparse targets come as points and segments files per sample
+        self.is_sparse = any(name.endswith("_segments.npy") for name in os.listdir(self.target_dir))
+
+        # Targets and nodes share the sample name, so they are named after their source rather than sorted apart
+        if self.is_sparse:
+            self.target_files = [name[:-len(".npy")] for name in self.source_files]
+        else:
+            self.target_files = list(self.source_files)
+        self.nodes_files = list(self.source_files)
 
         self.transform = transforms.Compose([transforms.Resize(size=image_size, interpolation=transforms.InterpolationMode.NEAREST)])
 
@@ -44,8 +80,7 @@ class SimpleDataset(Dataset):
             source_data = np.load(source_npy_path)
             source_tensor = self.transform(torch.from_numpy(source_data)) / self.max_pixel_value
 
-            target_npy_path = os.path.join(self.target_dir, self.target_files[idx])
-            target_data = np.load(target_npy_path)
+            target_data = self._load_target(idx, source_data.shape)
             target_tensor = self.transform(torch.from_numpy(target_data)).type(torch.float32)
 
             nodes_npy_path = os.path.join(self.nodes_dir, self.nodes_files[idx])
@@ -54,6 +89,16 @@ class SimpleDataset(Dataset):
 
             self.preloaded_data[idx] = (source_tensor, target_tensor, nodes_tensor)
 
+    def _load_target(self, idx, shape):
+        """Loads the target of a sample, densifying it if it is sparse."""
+        if not self.is_sparse:
+            return np.load(os.path.join(self.target_dir, self.target_files[idx]))
+
+        points = np.load(os.path.join(self.target_dir, self.target_files[idx] + "_points.npy"))
+        segments = np.load(os.path.join(self.target_dir, self.target_files[idx] + "_segments.npy"))
+
+        return densify(points, segments, shape)
+
     def __len__(self):
         """Returns the total number of npy files in the dataset."""
         return len(self.preloaded_data)
@@ -74,8 +119,7 @@ class SimpleDataset(Dataset):
         source_data = np.load(source_npy_path)
         source_tensor = self.transform(torch.from_numpy(source_data)) / self.max_pixel_value
 
-        target_npy_path = os.path.join(self.target_dir, self.target_files[idx])
-        target_data = np.load(target_npy_path)
+        target_data = self._load_target(idx, source_data.shape)
         target_tensor = self.transform(torch.from_numpy(target_data)).type(torch.float32)
 
         nodes_npy_path = os.path.join(self.nodes_dir, self.nodes_files[idx])
@@ -0,0 +1,52 @@
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+from dataset import SimpleDataset, densify
+
+
+class SimpleDatasetTest(unittest.TestCase):
+    def _write_sample(self, assets_dir, name, column):
+        """Writes a 1x4x4 sample whose target is a single path along the given column."""
+        source = np.zeros((1, 4, 4), dtype=np.uint8)
+        source[0, 0, column] = 1
+        source[0, 3, column] = 1
+
+        points = np.array([[column, 0, 0], [column, 3, 0]], dtype=np.uint8)
+        segments = np.array([[0, 1]], dtype=np.uint32)
+
+        np.save(os.path.join(assets_dir, "Source", name + ".npy"), source)
+        np.save(os.path.join(assets_dir, "Target", name + "_points.npy"), points)
+        np.save(os.path.join(assets_dir, "Target", name + "_segments.npy"), segments)
+        np.save(os.path.join(assets_dir, "Nodes", name + ".npy"), np.full(6, column, dtype=np.uint8))
+
+    def test_sparse_targets_follow_their_source(self):
+        # n10 sorts before n1 once suffixed, but after it as a plain .npy
+        with tempfile.TemporaryDirectory() as assets_dir:
+            for directory in ("Source", "Target", "Nodes"):
+                os.mkdir(os.path.join(assets_dir, directory))
+
+            self._write_sample(assets_dir, "s4_d1_p2_n1", 0)
+            self._write_sample(assets_dir, "s4_d1_p2_n10", 1)
+            self._write_sample(assets_dir, "s4_d1_p2_n2", 2)
+
+            dataset = SimpleDataset(assets_dir, (4, 4))
+
+            self.assertTrue(dataset.is_sparse)
+            self.assertEqual(len(dataset), 3)
+
+            for idx in range(len(dataset)):
+                source = np.load(os.path.join(dataset.source_dir, dataset.source_files[idx]))
+                column = int(np.flatnonzero(source[0, 0])[0])
+
+                points = np.array([[column, 0, 0], [column, 3, 0]])
+                expected = densify(points, np.array([[0, 1]]), source.shape)
+
+                np.testing.assert_array_equal(dataset._load_target(idx, source.shape), expected)
+                np.testing.assert_array_equal(np.load(os.path.join(dataset.nodes_dir, dataset.nodes_files[idx])), np.full(6, column))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -40,4 +40,16 @@ Depth = 1
 MinNumberOfPoints = 2
 MaxNumberOfPoints = 5
 DesiredCombinations = 10000
+LayerDirections = A
+TileSize = 0
+TileOverlap = 4
+Threads = 0
+Sampling = Stride
+Seed = 0
+
+[Output]
+
+Graph = false
+Target = Dense
+Features = false
 EOL
\ No newline at end of file